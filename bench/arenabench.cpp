@@ -0,0 +1,63 @@
+#include <thread>
+#include <vector>
+#include "benchmark.h"
+#include "jsonelementex.h"
+
+/*!
+ * 8 threads each building 40000 small documents on the heap and then in
+ * their own arena, the figures of the arena allocator.
+ */
+int main()
+{
+    std::string lDocument = "{\"id\":12,\"user\":{\"name\":\"someone\",\"tags\":[\"a\",\"b\"],\"address\":{\"city\":\"x\",\"zip\":\"12345\"}},\"items\":[";
+
+    for ( size_t lIndex = 0; lIndex < 20; ++lIndex ) {
+        if ( lIndex > 0 ) {
+            lDocument += ",";
+        }
+
+        lDocument += "{\"sku\":\"s" + std::to_string( lIndex ) + "\",\"qty\":" + std::to_string( lIndex ) + ",\"price\":1.5,\"meta\":{\"a\":1,\"b\":2}}";
+    }
+
+    lDocument += "]}";
+
+    constexpr size_t kThreads   = 8;
+    constexpr size_t kDocuments = 40000;
+
+    for ( const bool lArena : { false, true } ) {
+        const double lSeconds = bench::Seconds( 1, [ &lDocument, lArena ] ()
+                                                {
+                                                    std::vector<std::thread> lThreads;
+
+                                                    for ( size_t lIndex = 0; lIndex < kThreads; ++lIndex ) {
+                                                        lThreads.emplace_back( [ &lDocument, lArena ] ()
+                                                                               {
+                                                                                   jsbjson::JsonArena lMemory;
+
+                                                                                   for ( size_t lRun = 0; lRun < kDocuments; ++lRun ) {
+                                                                                       {
+                                                                                           jsbjson::JsonElementEx lElement;
+
+                                                                                           if ( lArena ) {
+                                                                                               lElement.FromJson( lDocument, lMemory );
+                                                                                           }
+                                                                                           else {
+                                                                                               lElement.FromJson( lDocument );
+                                                                                           }
+                                                                                       }
+
+                                                                                       lMemory.Release();
+                                                                                   }
+                                                                               } );
+                                                    }
+
+                                                    for ( std::thread& lThread : lThreads ) {
+                                                        lThread.join();
+                                                    }
+                                                } );
+
+        std::printf( "%s %.3f s\n", lArena ? "arena" : "heap ", lSeconds );
+    }
+
+    return 0;
+}
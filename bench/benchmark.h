@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+/*!
+ * Helpers of the benchmark programs. Each program is a single file that
+ * includes this header once, since it replaces the global operator new to
+ * count allocations. The aligned forms are replaced too because the heap
+ * resource of ArenaAllocator allocates through them.
+ */
+namespace bench
+{
+    inline std::atomic<size_t> gAllocations { 0 };
+    inline std::atomic<size_t> gBytes { 0 };
+
+    /*!
+     * Allocations and bytes allocated so far.
+     */
+    struct sUsage final
+    {
+        size_t Allocations = 0;
+        size_t Bytes       = 0;
+    };
+
+    inline sUsage Usage()
+    {
+        return { gAllocations.load(), gBytes.load() };
+    }
+
+    /*!
+     * Allocations and bytes aFunction makes.
+     */
+    template<typename FUNCTION>
+    sUsage Measure( FUNCTION&& aFunction )
+    {
+        const sUsage lBefore = Usage();
+        aFunction();
+        const sUsage lAfter = Usage();
+
+        return { lAfter.Allocations - lBefore.Allocations, lAfter.Bytes - lBefore.Bytes };
+    }
+
+    /*!
+     * Seconds aRuns calls of aFunction take in total.
+     */
+    template<typename FUNCTION>
+    double Seconds( const size_t aRuns,
+                    FUNCTION&&   aFunction )
+    {
+        const auto lStart = std::chrono::steady_clock::now();
+
+        for ( size_t lRun = 0; lRun < aRuns; ++lRun ) {
+            aFunction();
+        }
+
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - lStart ).count();
+    }
+
+    /*!
+     * {"arrayOfObjects":[...]} with aCount objects of a name, a location and
+     * an id.
+     */
+    inline std::string Orders( const size_t aCount,
+                               const char*  aNamePrefix,
+                               const char*  aLocation )
+    {
+        std::string lResult = "{\"arrayOfObjects\":[";
+
+        for ( size_t lIndex = 0; lIndex < aCount; ++lIndex ) {
+            if ( lIndex > 0 ) {
+                lResult += ",";
+            }
+
+            lResult += "{\"customerName\":\"" + std::string( aNamePrefix ) + std::to_string( lIndex )
+                       + "\",\"shippingLocation\":\"" + aLocation + "\",\"id\":" + std::to_string( lIndex ) + "}";
+        }
+
+        return lResult + "]}";
+    }
+}
+
+void* operator new( const size_t aSize )
+{
+    ++bench::gAllocations;
+    bench::gBytes += aSize;
+
+    if ( void* lMemory = std::malloc( aSize > 0 ? aSize : 1 ) ) {
+        return lMemory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new( const size_t          aSize,
+                    const std::align_val_t aAlignment )
+{
+    ++bench::gAllocations;
+    bench::gBytes += aSize;
+
+    const size_t lAlignment = static_cast<size_t>( aAlignment );
+
+    if ( void* lMemory = std::aligned_alloc( lAlignment, ( aSize + lAlignment - 1 ) / lAlignment * lAlignment ) ) {
+        return lMemory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete( void* aMemory ) noexcept
+{
+    std::free( aMemory );
+}
+
+void operator delete( void*        aMemory,
+                      const size_t ) noexcept
+{
+    std::free( aMemory );
+}
+
+void operator delete( void*                  aMemory,
+                      const std::align_val_t ) noexcept
+{
+    std::free( aMemory );
+}
+
+void operator delete( void*        aMemory,
+                      const size_t,
+                      const std::align_val_t ) noexcept
+{
+    std::free( aMemory );
+}
@@ -0,0 +1,41 @@
+#include "benchmark.h"
+#include "jsonelementex.h"
+
+/*!
+ * Allocations and build time of a DOM of 100k small objects with copied
+ * and with borrowed strings, the figures of borrowing from the input.
+ */
+int main()
+{
+    const std::string lDocument = bench::Orders( 100000, "customer number ", "somewhere far away from here" );
+
+    const bench::sUsage lCopied = bench::Measure( [ &lDocument ] ()
+                                                  {
+                                                      jsbjson::JsonElementEx lElement;
+                                                      lElement.FromJson( lDocument );
+                                                  } );
+
+    const bench::sUsage lBorrowed = bench::Measure( [ &lDocument ] ()
+                                                    {
+                                                        jsbjson::JsonElementEx lElement;
+                                                        lElement.FromJsonBorrowed( lDocument );
+                                                    } );
+
+    constexpr size_t kRuns = 5;
+
+    const double lCopiedSeconds = bench::Seconds( kRuns, [ &lDocument ] ()
+                                                  {
+                                                      jsbjson::JsonElementEx lElement;
+                                                      lElement.FromJson( lDocument );
+                                                  } );
+
+    const double lBorrowedSeconds = bench::Seconds( kRuns, [ &lDocument ] ()
+                                                    {
+                                                        jsbjson::JsonElementEx lElement;
+                                                        lElement.FromJsonBorrowed( lDocument );
+                                                    } );
+
+    std::printf( "copied allocations %zu parse %.3f s\nborrowed allocations %zu parse %.3f s\n",
+                 lCopied.Allocations, lCopiedSeconds / kRuns, lBorrowed.Allocations, lBorrowedSeconds / kRuns );
+    return 0;
+}
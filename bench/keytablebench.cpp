@@ -0,0 +1,27 @@
+#include "benchmark.h"
+#include "jsonelementex.h"
+
+/*!
+ * Allocations and parse time of a DOM build on a 100k item array of
+ * objects, the figures of interning object keys.
+ */
+int main()
+{
+    const std::string lDocument = bench::Orders( 100000, "n", "x" );
+
+    const bench::sUsage lUsage = bench::Measure( [ &lDocument ] ()
+                                                 {
+                                                     jsbjson::JsonElementEx lElement;
+                                                     lElement.FromJson( lDocument );
+                                                 } );
+
+    constexpr size_t kRuns    = 5;
+    const double     lSeconds = bench::Seconds( kRuns, [ &lDocument ] ()
+                                                {
+                                                    jsbjson::JsonElementEx lElement;
+                                                    lElement.FromJson( lDocument );
+                                                } );
+
+    std::printf( "allocations %zu bytes %zu parse %.3f s\n", lUsage.Allocations, lUsage.Bytes, lSeconds / kRuns );
+    return 0;
+}
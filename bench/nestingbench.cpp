@@ -0,0 +1,35 @@
+#include "benchmark.h"
+#include "jsonelementex.h"
+
+/*!
+ * DOM builds of a document nested 1000 levels deep and of a flat 100k item
+ * array, the figures of building the DOM on a container stack.
+ */
+int main()
+{
+    constexpr size_t kDepth = 1000;
+    std::string      lNested;
+
+    for ( size_t lLevel = 0; lLevel < kDepth; ++lLevel ) {
+        lNested += "{\"k\":[1,2,3,{\"x\":\"payload payload payload\"}],\"n\":";
+    }
+
+    lNested += "1" + std::string( kDepth, '}' );
+
+    const std::string lFlat = bench::Orders( 100000, "n", "x" );
+
+    const double lNestedSeconds = bench::Seconds( 50, [ &lNested ] ()
+                                                  {
+                                                      jsbjson::JsonElementEx lElement;
+                                                      lElement.FromJson( lNested );
+                                                  } );
+
+    const double lFlatSeconds = bench::Seconds( 5, [ &lFlat ] ()
+                                                {
+                                                    jsbjson::JsonElementEx lElement;
+                                                    lElement.FromJson( lFlat );
+                                                } );
+
+    std::printf( "nested %zu levels, 50 parses %.3f s\nflat 100k items, 5 parses %.3f s\n", kDepth, lNestedSeconds, lFlatSeconds );
+    return 0;
+}
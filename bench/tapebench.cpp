@@ -0,0 +1,60 @@
+#include "benchmark.h"
+#include "jsonelementex.h"
+#include "jsontape.h"
+
+/*!
+ * Builds and scans of a 200k item array as a tape and as a DOM, the
+ * figures of the tape document.
+ */
+int main()
+{
+    std::string lDocument = "{\"price\":{\"value\":12},\"arrayOfObjects\":[";
+
+    for ( size_t lIndex = 0; lIndex < 200000; ++lIndex ) {
+        if ( lIndex > 0 ) {
+            lDocument += ",";
+        }
+
+        lDocument += "{\"name\":\"n" + std::to_string( lIndex ) + "\",\"location\":\"x\",\"v\":" + std::to_string( lIndex ) + "}";
+    }
+
+    lDocument += "],\"tail\":1}";
+
+    constexpr size_t kRuns = 10;
+
+    jsbjson::JsonTape      lTape;
+    jsbjson::JsonElementEx lElement;
+
+    const double lTapeBuild = bench::Seconds( kRuns, [ & ] ()
+                                              {
+                                                  lTape.Parse( lDocument );
+                                              } );
+
+    const double lDomBuild = bench::Seconds( kRuns, [ & ] ()
+                                             {
+                                                 lElement.FromJson( lDocument );
+                                             } );
+
+    uint64_t lTapeSum = 0;
+    uint64_t lDomSum  = 0;
+
+    const double lTapeScan = bench::Seconds( kRuns, [ & ] ()
+                                             {
+                                                 const jsbjson::TapeArray lItems = *lTape.Root()[ "arrayOfObjects" ].GetValue<jsbjson::TapeArray>();
+
+                                                 for ( const jsbjson::TapeValue lItem : lItems ) {
+                                                     lTapeSum += *lItem[ "v" ].GetValue<uint64_t>();
+                                                 }
+                                             } );
+
+    const double lDomScan = bench::Seconds( kRuns, [ & ] ()
+                                            {
+                                                for ( const jsbjson::JsonVariant& lItem : lElement[ "arrayOfObjects" ].GetValueRef<std::vector<jsbjson::JsonVariant>>() ) {
+                                                    lDomSum += lItem.GetValueRef<jsbjson::JsonElement>().at( "v" ).GetValueRef<uint64_t>();
+                                                }
+                                            } );
+
+    std::printf( "%zu runs, build tape %.3f s dom %.3f s, scan tape %.4f s dom %.4f s%s\n",
+                 kRuns, lTapeBuild, lDomBuild, lTapeScan, lDomScan, lTapeSum == lDomSum ? "" : " (sums differ)" );
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include "benchmark.h"
+#include "jsonelementex.h"
+
+/*!
+ * Sizes of a value and of an object member, and bytes allocated and build
+ * time of a DOM of 100k small objects, the figures of the 16 byte values.
+ */
+int main()
+{
+    const std::string lShort = bench::Orders( 100000, "n", "x" );
+    const std::string lLong  = bench::Orders( 100000, "customer number ", "somewhere far away from here" );
+
+    std::printf( "array item %zu bytes, object member %zu bytes\n", sizeof( jsbjson::JsonVariant ), sizeof( jsbjson::JsonElement::value_type ) );
+
+    constexpr size_t kRuns = 5;
+
+    for ( const std::string* lDocument : { &lShort, &lLong } ) {
+        const bench::sUsage lUsage = bench::Measure( [ lDocument ] ()
+                                                     {
+                                                         jsbjson::JsonElementEx lElement;
+                                                         lElement.FromJson( *lDocument );
+                                                     } );
+
+        const double lSeconds = bench::Seconds( kRuns, [ lDocument ] ()
+                                                {
+                                                    jsbjson::JsonElementEx lElement;
+                                                    lElement.FromJson( *lDocument );
+                                                } );
+
+        std::printf( "%s strings: %zu bytes allocated, parse %.3f s\n", lDocument == &lShort ? "short" : "long ", lUsage.Bytes, lSeconds / kRuns );
+    }
+
+    return 0;
+}
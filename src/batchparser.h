@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "structuralindex.h"
+#include "jsonelementex.h"
+#include "toobject.h"
+#include "threadpool.h"
+
+namespace jsbjson
+{
+    enum class eBatchFormat
+    {
+        NewlineDelimited
+        , Concatenated
+    };
+
+    /*!
+     * Parses a buffer holding many JSON documents (NDJSON or documents written
+     * back to back) on a thread pool. Results are returned in input order, a
+     * record that fails to parse yields an empty optional. Back to back
+     * documents are split on the structural index, so such a buffer cannot be
+     * larger than StructuralIndex::kMaxDocumentSize.
+     */
+    class BatchParser final
+    {
+    public:
+        explicit BatchParser( const size_t aThreadCount = std::thread::hardware_concurrency() )
+            : mPool( aThreadCount )
+        {}
+
+        /*!
+         * Fails for back to back documents in a buffer too large to index.
+         */
+        static bool SplitRecords( const std::string_view         aBuffer,
+                                  const eBatchFormat             aFormat,
+                                  std::vector<std::string_view>& aRecords )
+        {
+            aRecords.clear();
+
+            if ( aFormat == eBatchFormat::NewlineDelimited ) {
+                SplitLines( aBuffer, aRecords );
+                return true;
+            }
+
+            return SplitDocuments( aBuffer, aRecords );
+        }
+
+        /*!
+         * Fails when the buffer cannot be split into records, aResults is
+         * left empty then.
+         */
+        bool ParseElements( const std::string_view                     aBuffer,
+                            std::vector<std::optional<JsonElementEx>>& aResults,
+                            const eBatchFormat                         aFormat = eBatchFormat::NewlineDelimited )
+        {
+            return ParseRecords<JsonElementEx>( aBuffer, aFormat, aResults, [] ( const std::string_view aRecord ) -> std::optional<JsonElementEx>
+                                                {
+                                                    JsonElementEx lElement;
+
+                                                    if ( !lElement.FromJson( aRecord ) ) {
+                                                        return std::nullopt;
+                                                    }
+
+                                                    return lElement;
+                                                } );
+        }
+
+        template<typename OBJECT>
+        bool ParseObjects( const std::string_view              aBuffer,
+                           std::vector<std::optional<OBJECT>>& aResults,
+                           const eBatchFormat                  aFormat = eBatchFormat::NewlineDelimited )
+        {
+            return ParseRecords<OBJECT>( aBuffer, aFormat, aResults, [] ( const std::string_view aRecord )
+                                         {
+                                             return ToObject<OBJECT> {}( aRecord );
+                                         } );
+        }
+
+    private:
+        static bool IsBlank( const std::string_view aText )
+        {
+            for ( const char lChar : aText ) {
+                if ( ( lChar != ' ' ) && ( lChar != '\t' ) && ( lChar != '\r' ) && ( lChar != '\n' ) ) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static void SplitLines( const std::string_view         aBuffer,
+                                std::vector<std::string_view>& aRecords )
+        {
+            // raw line breaks are not allowed inside json strings, so every '\n' ends a record
+            const char* lCursor = aBuffer.data();
+            const char* lEnd    = lCursor + aBuffer.size();
+
+            while ( lCursor != lEnd ) {
+                const char* lLineEnd = static_cast<const char*>( std::memchr( lCursor, '\n', lEnd - lCursor ) );
+
+                if ( lLineEnd == nullptr ) {
+                    lLineEnd = lEnd;
+                }
+
+                const std::string_view lLine( lCursor, lLineEnd - lCursor );
+
+                if ( !IsBlank( lLine ) ) {
+                    aRecords.push_back( lLine );
+                }
+
+                lCursor = lLineEnd == lEnd
+                          ? lEnd
+                          : lLineEnd + 1;
+            }
+        }
+
+        static bool SplitDocuments( const std::string_view         aBuffer,
+                                    std::vector<std::string_view>& aRecords )
+        {
+            if ( aBuffer.size() > StructuralIndex::kMaxDocumentSize ) {
+                return false;
+            }
+
+            StructuralIndex lIndex;
+            lIndex.Build( aBuffer );
+
+            // only brackets outside of strings are indexed, so a depth counter finds the document ends
+            size_t lDepth       = 0;
+            size_t lBegin       = 0;
+            size_t lPreviousEnd = 0;
+
+            for ( const uint32_t lPosition : lIndex.Positions() ) {
+                const char lChar = aBuffer[ lPosition ];
+
+                if ( ( lChar == '{' ) || ( lChar == '[' ) ) {
+                    if ( lDepth++ == 0 ) {
+                        lBegin = lPosition;
+                        AddGarbage( aBuffer.substr( lPreviousEnd, lBegin - lPreviousEnd ), aRecords );
+                    }
+
+                    continue;
+                }
+
+                if ( ( ( lChar == '}' ) || ( lChar == ']' ) ) && ( lDepth > 0 ) && ( --lDepth == 0 ) ) {
+                    lPreviousEnd = lPosition + 1;
+                    aRecords.push_back( aBuffer.substr( lBegin, lPreviousEnd - lBegin ) );
+                }
+            }
+
+            if ( lDepth > 0 ) {
+                aRecords.push_back( aBuffer.substr( lBegin ) );
+            }
+            else {
+                AddGarbage( aBuffer.substr( lPreviousEnd ), aRecords );
+            }
+
+            return true;
+        }
+
+        static void AddGarbage( const std::string_view         aText,
+                                std::vector<std::string_view>& aRecords )
+        {
+            // text between documents is handed to the parser so it is reported as a failed record
+            if ( !IsBlank( aText ) ) {
+                aRecords.push_back( aText );
+            }
+        }
+
+        template<typename RESULT, typename FUNCTION>
+        bool ParseRecords( const std::string_view              aBuffer,
+                           const eBatchFormat                  aFormat,
+                           std::vector<std::optional<RESULT>>& aResults,
+                           FUNCTION&&                          aParseRecord )
+        {
+            std::vector<std::string_view> lRecords;
+            aResults.clear();
+
+            if ( !SplitRecords( aBuffer, aFormat, lRecords ) ) {
+                return false;
+            }
+
+            aResults.resize( lRecords.size() );
+
+            // a task covers a run of records so that tiny records do not drown in scheduling cost
+            const size_t lTaskCount   = std::min( lRecords.size(), mPool.Size() * kTasksPerThread );
+            const size_t lTaskRecords = lTaskCount == 0
+                                        ? 0
+                                        : ( lRecords.size() + lTaskCount - 1 ) / lTaskCount;
+
+            mPool.ParallelFor( lTaskCount, [ & ] ( const size_t aTask )
+                               {
+                                   const size_t lBegin = aTask * lTaskRecords;
+                                   const size_t lEnd   = std::min( lBegin + lTaskRecords, lRecords.size() );
+
+                                   for ( size_t lIndex = lBegin; lIndex < lEnd; ++lIndex ) {
+                                       aResults[ lIndex ] = aParseRecord( lRecords[ lIndex ] );
+                                   }
+                               } );
+
+            return true;
+        }
+
+    private:
+        static constexpr size_t kTasksPerThread = 16;
+
+        ThreadPool mPool;
+    };
+}
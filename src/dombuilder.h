@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "jsonelement.h"
+#include "jsonkey.h"
+
+namespace jsbjson
+{
+    /*!
+     * Builds a JsonElement from parser events for the DOM notifiers. Each open
+     * container is a frame on a stack and a finished one is moved into its
+     * parent, so building is linear in the size of the document.
+     */
+    class DomBuilder final
+    {
+    public:
+        explicit DomBuilder( KeyTable& aKeys )
+            : mKeys( aKeys )
+        {}
+
+        void Start()
+        {
+            mStack.clear();
+            mDocument = JsonVariant {};
+        }
+
+        /*!
+         * Moves the document into aRoot if it is an object.
+         */
+        void Finish( JsonElement& aRoot )
+        {
+            if ( !mDocument.IsA<JsonElement>() ) {
+                return;
+            }
+
+            aRoot = std::move( mDocument.GetValueRef<JsonElement>() );
+        }
+
+        bool IsOpen() const
+        {
+            return !mStack.empty();
+        }
+
+        template<typename CONTAINER>
+        void Open( CONTAINER&&            aEmpty,
+                   const std::string_view aName )
+        {
+            const bool lNamed = !mStack.empty() && mStack.back().Value.IsA<JsonElement>();
+
+            mStack.emplace_back();
+            mStack.back().Value = JsonVariant( std::forward<CONTAINER>( aEmpty ) );
+
+            if ( lNamed ) {
+                mStack.back().Name = mKeys.Intern( aName );
+            }
+        }
+
+        /*!
+         * Moves the finished container into its parent, the outermost one is
+         * kept until the document is complete.
+         */
+        void Close()
+        {
+            Frame lFrame = std::move( mStack.back() );
+            mStack.pop_back();
+
+            if ( mStack.empty() ) {
+                mDocument = std::move( lFrame.Value );
+                return;
+            }
+
+            Add( lFrame.Name, std::move( lFrame.Value ) );
+        }
+
+        void AddValue( const std::string_view aName,
+                       JsonVariant&&          aValue )
+        {
+            if ( mStack.back().Value.IsArray() ) {
+                Add( JsonKey {}, std::move( aValue ) );
+                return;
+            }
+
+            Add( mKeys.Intern( aName ), std::move( aValue ) );
+        }
+
+    private:
+        /*!
+         * A container being built and the key it goes to in its parent, the
+         * key is only set when the parent is an object.
+         */
+        struct Frame final
+        {
+            JsonVariant Value;
+            JsonKey     Name;
+        };
+
+        void Add( const JsonKey& aName,
+                  JsonVariant&&  aValue )
+        {
+            JsonVariant& lParent = mStack.back().Value;
+
+            if ( lParent.IsArray() ) {
+                lParent.GetValueRef<std::vector<JsonVariant>>().push_back( std::move( aValue ) );
+                return;
+            }
+
+            lParent.GetValueRef<JsonElement>()[ aName ] = std::move( aValue );
+        }
+
+    private:
+        KeyTable&          mKeys;
+        std::vector<Frame> mStack;      /*!<containers being built, innermost last*/
+        JsonVariant        mDocument;
+    };
+}
@@ -22,17 +22,17 @@ namespace jsbjson
             size_t      lIndex = 0;
 
             for ( const auto& lItem : aArray ) {
-                if ( std::holds_alternative<std::vector<JsonVariant>>( lItem.Value ) ) {
-                    lResult += "[" + ProcessArray( std::get<std::vector<JsonVariant>>( lItem.Value ) ) + "]";
+                if ( lItem.IsArray() ) {
+                    lResult += "[" + ProcessArray( lItem.GetValueRef<std::vector<JsonVariant>>() ) + "]";
                 }
-                else if ( std::holds_alternative<JsonElement>( lItem.Value ) ) {
-                    lResult += "{" + FromMap {}( std::get<JsonElement>( lItem.Value ), false ) + "}";
+                else if ( lItem.IsA<JsonElement>() ) {
+                    lResult += "{" + FromMap {}( lItem.GetValueRef<JsonElement>(), false ) + "}";
                 }
                 else {
-                    std::visit( [ & ] (const auto& aValue)
-                                {
-                                    lResult += ToSimpleValue<std::decay_t<decltype( aValue )>> {}( aValue );
-                                }, lItem.Value );
+                    lItem.Visit( [ & ] (const auto& aValue)
+                                 {
+                                     lResult += ToSimpleValue<std::decay_t<decltype( aValue )>> {}( aValue );
+                                 } );
                 }
 
                 ++lIndex;
@@ -58,19 +58,19 @@ namespace jsbjson
             size_t lIndex = 0;
 
             for ( const auto& [ lKey, lValue ] : aElement ) {
-                lResult += "\"" + lKey + "\":";
+                lResult += text::Quote( lKey.Str() ) + ":";
 
-                if ( std::holds_alternative<JsonElement>( lValue.Value ) ) {
-                    lResult += "{" + FromMap {}( std::get<JsonElement>( lValue.Value ), false ) + "}";
+                if ( lValue.IsA<JsonElement>() ) {
+                    lResult += "{" + FromMap {}( lValue.GetValueRef<JsonElement>(), false ) + "}";
                 }
-                else if ( std::holds_alternative<std::vector<JsonVariant>>( lValue.Value ) ) {
-                    lResult += "[" + ProcessArray( std::get<std::vector<JsonVariant>>( lValue.Value ) ) + "]";
+                else if ( lValue.IsArray() ) {
+                    lResult += "[" + ProcessArray( lValue.GetValueRef<std::vector<JsonVariant>>() ) + "]";
                 }
                 else {
-                    std::visit( [ & ] (const auto& aValue)
-                                {
-                                    lResult += ToSimpleValue<std::decay_t<decltype( aValue )>> {}( aValue );
-                                }, lValue.Value );
+                    lValue.Visit( [ & ] (const auto& aValue)
+                                  {
+                                      lResult += ToSimpleValue<std::decay_t<decltype( aValue )>> {}( aValue );
+                                  } );
                 }
 
                 ++lIndex;
@@ -48,8 +48,8 @@ namespace jsbjson
                 std::apply( [ & ] ( const auto&... aMembers )
                             {
                                 if ( !aIsRoot ) {
-                                    aJsonElement[ aObject.Name() ] = JsonElement {};
-                                    JsonElement& lElement          = aJsonElement[ aObject.Name() ].GetValueRef<JsonElement>();
+                                    aJsonElement[ KeyOf( aObject ) ] = JsonElement {};
+                                    JsonElement& lElement            = aJsonElement[ KeyOf( aObject ) ].GetValueRef<JsonElement>();
                                     ( Process( aMembers, lElement, false ), ... );
                                 }
                                 else {
@@ -61,12 +61,12 @@ namespace jsbjson
             if constexpr ( IsMember<std::decay_t<ITEM>>::value ) {
                 if ( aObject.IsSet ) {
                     if constexpr ( IsArray<std::decay_t<typename ITEM::Type>>::value ) {
-                        aJsonElement[ aObject.Name() ]     = std::vector<JsonVariant> {};
-                        std::vector<JsonVariant>& lElement = aJsonElement[ aObject.Name() ].GetValueRef<std::vector<JsonVariant>>();
+                        aJsonElement[ KeyOf( aObject ) ]   = std::vector<JsonVariant> {};
+                        std::vector<JsonVariant>& lElement = aJsonElement[ KeyOf( aObject ) ].GetValueRef<std::vector<JsonVariant>>();
                         ProcessArray( aObject.Value, lElement );
                     }
                     else {
-                        aJsonElement[ aObject.Name() ] = aObject.Value;
+                        aJsonElement[ KeyOf( aObject ) ] = aObject.Value;
                     }
                 }
             }
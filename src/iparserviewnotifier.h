@@ -0,0 +1,42 @@
+#pragma once
+#include <variant>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include "iparsernotifier.h"
+
+namespace jsbjson
+{
+    /*!
+     * Event interface passing names and string values as views. A view points
+     * into the input when the text needed no unescaping and into a parser
+     * buffer otherwise, either way it is only valid during the call.
+     */
+    class IParserViewNotifier
+    {
+    public:
+        using eValueType = IParserNotifier::eValueType;
+        using Value      = std::variant<uint64_t, int64_t, double, bool, std::string_view>;
+
+    public:
+        virtual void OnParsingStarted() = 0;
+        virtual void OnObjectBegin( const size_t           aID,
+                                    const size_t           aParentID,
+                                    const std::string_view aName ) = 0;
+        virtual void OnObjectFinished( const size_t aID )          = 0;
+        virtual void OnItemBegin( const size_t aParentID )         = 0;
+        virtual void OnItemName( const std::string_view aName,
+                                 const size_t           aParentID ) = 0;
+        virtual void OnItemValueBegin( const eValueType aType )     = 0;
+        virtual void OnItemValue( const Value&           aValue,
+                                  const size_t           aParentID,
+                                  const std::string_view aName ) = 0;
+        virtual void OnArrayBegin( const size_t           aID,
+                                   const size_t           aParentID,
+                                   const std::string_view aName ) = 0;
+        virtual void OnNextItem()                                 = 0;
+        virtual void OnArrayFinished( const size_t aID )          = 0;
+        virtual void OnParsingFinished()                          = 0;
+        virtual void OnError( const std::string& aError )         = 0;
+    };
+}
@@ -1,9 +1,32 @@
 #pragma once
 #include "jsonobject.h"
+#include "jsonkey.h"
+#include "jsonarena.h"
+#include "segmentedvector.h"
+#include "orderedmap.h"
+#include "iparserviewnotifier.h"
 #include "parser.h"
+#include "structuralindex.h"
+#include "mappedfile.h"
+#include "nestingstack.h"
+#include "powersoffive.h"
+#include "numberparser.h"
+#include "jsonstring.h"
+#include "dombuilder.h"
 #include "mapparsernotifier.h"
+#include "mapviewparsernotifier.h"
 #include "frommap.h"
+#include "ondemandbinder.h"
+#include "jsonpointer.h"
+#include "pointerextractor.h"
+#include "jsonfilter.h"
+#include "jsontape.h"
+#include "jsonreader.h"
+#include "jsonvalidator.h"
 #include "toobject.h"
 #include "fromobject.h"
 #include "jsonelement.h"
 #include "jsonelementex.h"
+#include "threadpool.h"
+#include "batchparser.h"
+#include "parallelparser.h"
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+
+namespace jsbjson
+{
+    /*!
+     * Memory for the objects of parsed documents. Blocks are taken from the
+     * heap as needed and only given back all at once, so building a DOM in an
+     * arena costs a pointer bump per node and freeing it a few block frees.
+     * Everything built in the arena must be gone before Release() or before
+     * the arena is destroyed.
+     */
+    class JsonArena final
+    {
+    public:
+        explicit JsonArena( const size_t aInitialSize = 64 * 1024 )
+            : mInitialBlock( new std::byte[ aInitialSize ] )
+            , mResource( mInitialBlock.get(), aInitialSize )
+        {}
+
+        JsonArena( const JsonArena& )            = delete;
+        JsonArena& operator=( const JsonArena& ) = delete;
+
+        std::pmr::memory_resource* Resource()
+        {
+            return &mResource;
+        }
+
+        /*!
+         * Frees all blocks at once, the initial block is kept for reuse so a
+         * document that fits in it allocates nothing.
+         */
+        void Release()
+        {
+            mResource.release();
+        }
+
+    private:
+        std::unique_ptr<std::byte[]>        mInitialBlock;
+        std::pmr::monotonic_buffer_resource mResource;
+    };
+
+    namespace arena
+    {
+        /*!
+         * Resource new DOM containers allocate from on this thread, the heap
+         * unless an ArenaScope is active.
+         */
+        inline std::pmr::memory_resource*& Current()
+        {
+            thread_local std::pmr::memory_resource* lResource = std::pmr::new_delete_resource();
+            return lResource;
+        }
+    }
+
+    /*!
+     * Makes the DOM containers created on this thread while it lives allocate
+     * from aArena, or from any other resource.
+     */
+    class ArenaScope final
+    {
+    public:
+        explicit ArenaScope( JsonArena& aArena )
+            : ArenaScope( aArena.Resource() )
+        {}
+
+        explicit ArenaScope( std::pmr::memory_resource* aResource )
+            : mPrevious( arena::Current() )
+        {
+            arena::Current() = aResource;
+        }
+
+        ArenaScope( const ArenaScope& )            = delete;
+        ArenaScope& operator=( const ArenaScope& ) = delete;
+
+        ~ArenaScope()
+        {
+            arena::Current() = mPrevious;
+        }
+
+    private:
+        std::pmr::memory_resource* mPrevious;
+    };
+
+    /*!
+     * Allocator of the DOM containers. It binds to the thread's current
+     * resource when constructed and moves with its container, copies of a
+     * container bind to the resource current where they are made.
+     */
+    template<typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type                             = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap            = std::true_type;
+
+        ArenaAllocator()
+            : mResource( arena::Current() )
+        {}
+
+        template<typename OTHER>
+        ArenaAllocator( const ArenaAllocator<OTHER>& aOther )
+            : mResource( aOther.Resource() )
+        {}
+
+        T* allocate( const size_t aCount )
+        {
+            return static_cast<T*>( mResource->allocate( aCount * sizeof( T ), alignof( T ) ) );
+        }
+
+        void deallocate( T*           aPointer,
+                         const size_t aCount )
+        {
+            mResource->deallocate( aPointer, aCount * sizeof( T ), alignof( T ) );
+        }
+
+        ArenaAllocator select_on_container_copy_construction() const
+        {
+            return ArenaAllocator {};
+        }
+
+        std::pmr::memory_resource* Resource() const
+        {
+            return mResource;
+        }
+
+        template<typename OTHER>
+        bool operator ==( const ArenaAllocator<OTHER>& aOther ) const
+        {
+            return mResource == aOther.Resource();
+        }
+
+        template<typename OTHER>
+        bool operator !=( const ArenaAllocator<OTHER>& aOther ) const
+        {
+            return mResource != aOther.Resource();
+        }
+
+    private:
+        std::pmr::memory_resource* mResource;
+    };
+}
@@ -1,72 +1,232 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <new>
 #include <optional>
-#include <variant>
-#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "typehelpers.h"
+#include "jsonkey.h"
+#include "jsonarena.h"
+#include "orderedmap.h"
 
 namespace jsbjson
 {
     struct JsonVariant;
-    using JsonElement = std::unordered_map<std::string, JsonVariant>;
+    using JsonElement = OrderedMap<JsonKey, JsonVariant, JsonKey::Hash, ArenaAllocator<std::pair<JsonKey, JsonVariant>>>;
 
     struct sEmptyValue {};
 
-    using JsonVariantRecursive = std::variant<sEmptyValue, int32_t, uint32_t, int64_t, uint64_t, std::string, bool, double, JsonElement, std::vector<JsonVariant>>;
-    struct JsonVariant
+    /*!
+     * Value of a member or an array item in 16 bytes. Numbers, bools and
+     * strings of up to kShortSize bytes are stored inline. Longer strings,
+     * objects and arrays live in a block allocated from the resource current
+     * when the value was made, see ArenaScope. A borrowed string points into
+     * a buffer owned by the caller, see Borrowed().
+     */
+    struct alignas( 8 ) JsonVariant
     {
     public:
-        JsonVariantRecursive Value;
+        enum class eType : uint8_t
+        {
+            Empty
+            , Int32
+            , UInt32
+            , Int64
+            , UInt64
+            , Bool
+            , Double
+            , ShortString       /*!<inline*/
+            , Text              /*!<immutable characters in a block*/
+            , String            /*!<std::string in a block*/
+            , BorrowedString    /*!<characters owned by the caller*/
+            , Object
+            , Array
+        };
+
+        static constexpr size_t kShortSize = 14;
 
         JsonVariant( const int32_t aValue )
-            : Value( aValue )
-        {}
+        {
+            Store( eType::Int32, aValue );
+        }
 
         JsonVariant( const uint32_t aValue )
-            : Value( aValue )
-        {}
+        {
+            Store( eType::UInt32, aValue );
+        }
 
         JsonVariant( const int64_t aValue )
-            : Value( aValue )
-        {}
+        {
+            Store( eType::Int64, aValue );
+        }
 
         JsonVariant( const uint64_t aValue )
-            : Value( aValue )
-        {}
+        {
+            Store( eType::UInt64, aValue );
+        }
 
         JsonVariant( const std::string& aValue )
-            : Value( aValue )
-        {}
+        {
+            StoreText( aValue );
+        }
+
+        JsonVariant( std::string&& aValue )
+        {
+            if ( aValue.size() <= kShortSize ) {
+                StoreText( aValue );
+                return;
+            }
+
+            StoreBox( eType::String, MakeBox<std::string>( std::move( aValue ) ) );
+        }
+
         JsonVariant( const bool aValue )
-            : Value( aValue )
-        {}
+        {
+            Store( eType::Bool, aValue );
+        }
 
         JsonVariant( const double aValue )
-            : Value( aValue )
-        {}
+        {
+            Store( eType::Double, aValue );
+        }
 
         JsonVariant( const JsonElement& aValue )
-            : Value( aValue )
-        {}
+        {
+            StoreBox( eType::Object, MakeBox<JsonElement>( aValue ) );
+        }
+
+        JsonVariant( JsonElement&& aValue )
+        {
+            StoreBox( eType::Object, MakeBox<JsonElement>( std::move( aValue ) ) );
+        }
 
         JsonVariant( const std::vector<JsonVariant>& aValue )
-            : Value( aValue )
-        {}
+        {
+            StoreBox( eType::Array, MakeBox<std::vector<JsonVariant>>( aValue ) );
+        }
+
+        JsonVariant( std::vector<JsonVariant>&& aValue )
+        {
+            StoreBox( eType::Array, MakeBox<std::vector<JsonVariant>>( std::move( aValue ) ) );
+        }
 
         JsonVariant()
-            : Value( sEmptyValue {} )
         {};
 
+        JsonVariant( const JsonVariant& aOther )
+        {
+            CopyFrom( aOther );
+        }
+
+        /*!
+         * Takes the value over, its blocks stay with the resource they came
+         * from, see CopyTo().
+         */
+        JsonVariant( JsonVariant&& aOther ) noexcept
+        {
+            std::memcpy( mData, aOther.mData, sizeof( mData ) );
+            mType        = aOther.mType;
+            aOther.mType = eType::Empty;
+        }
+
+        JsonVariant& operator=( const JsonVariant& aOther )
+        {
+            if ( this != &aOther ) {
+                *this = JsonVariant( aOther );
+            }
+
+            return *this;
+        }
+
+        /*!
+         * aOther may be part of this value, so it is taken over before the
+         * old value is freed.
+         */
+        JsonVariant& operator=( JsonVariant&& aOther ) noexcept
+        {
+            if ( this == &aOther ) {
+                return *this;
+            }
+
+            unsigned char lData[ sizeof( mData ) ];
+            const eType   lType = aOther.mType;
+
+            std::memcpy( lData, aOther.mData, sizeof( mData ) );
+            aOther.mType = eType::Empty;
+            Reset();
+            std::memcpy( mData, lData, sizeof( mData ) );
+            mType = lType;
+            return *this;
+        }
+
+        ~JsonVariant()
+        {
+            Reset();
+        }
+
+        /*!
+         * String that points into a buffer owned by the caller, which must
+         * outlive the value and its copies. It reads as a std::string and is
+         * copied into one the first time GetValueRef<std::string>() is
+         * called. Short strings are copied
+         * inline right away.
+         */
+        static JsonVariant Borrowed( const std::string_view aText )
+        {
+            JsonVariant lVariant;
+
+            if ( ( aText.size() <= kShortSize ) || ( aText.size() > std::numeric_limits<uint32_t>::max() ) ) {
+                lVariant.StoreText( aText );
+                return lVariant;
+            }
+
+            new ( lVariant.mData ) const char*( aText.data() );
+            lVariant.StoreSize( aText.size() );
+            lVariant.mType = eType::BorrowedString;
+            return lVariant;
+        }
+
+        /*!
+         * Copy whose strings, objects and arrays are allocated from
+         * aResource, std::pmr::new_delete_resource() takes a value out of an
+         * arena before the arena is released.
+         */
+        JsonVariant CopyTo( std::pmr::memory_resource* aResource ) const
+        {
+            const ArenaScope lScope( aResource );
+            return JsonVariant( *this );
+        }
+
+        eType Type() const
+        {
+            return mType;
+        }
+
+        bool IsBorrowed() const
+        {
+            return mType == eType::BorrowedString;
+        }
+
         bool IsArray() const
         {
-            return std::holds_alternative<std::vector<JsonVariant>>( Value );
+            return mType == eType::Array;
         }
 
         template<typename T>
         bool IsA() const
         {
-            if constexpr ( IsValidType<T>() ) {
-                return std::holds_alternative<T>( Value );
+            if constexpr ( std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ) {
+                return ( mType >= eType::ShortString ) && ( mType <= eType::BorrowedString );
+            }
+            else if constexpr ( IsValidType<T>() ) {
+                return mType == TypeOf<T>();
             }
             else {
                 return false;
@@ -83,11 +243,16 @@ namespace jsbjson
                    || std::is_same_v<T, int64_t>
                    || std::is_same_v<T, uint64_t>
                    || std::is_same_v<T, std::string>
+                   || std::is_same_v<T, std::string_view>
                    || std::is_same_v<T, bool>
                    || std::is_same_v<T, double>
                    || std::is_same_v<T, JsonElement>;
         }
 
+        /*!
+         * A std::string_view of a string stored inline stays valid only while
+         * this value is neither changed nor moved.
+         */
         template<typename T>
         std::optional<T> GetValue() const
         {
@@ -117,47 +282,401 @@ namespace jsbjson
                 return std::nullopt;
             }
 
-            if constexpr ( IsValidType<std::decay_t<T>>() ) {
-                return std::get<std::decay_t<T>>( Value );
+            if constexpr ( std::is_same_v<std::decay_t<T>, std::string> || std::is_same_v<std::decay_t<T>, std::string_view> ) {
+                return std::decay_t<T>( Text() );
+            }
+            else if constexpr ( IsValidType<std::decay_t<T>>() ) {
+                return GetValueRef<std::decay_t<T>>();
             }
             else {
                 return std::nullopt;
             }
         }
 
+        /*!
+         * Most strings are not stored as a std::string, so a const value has
+         * no std::string to refer to. Read strings with
+         * GetValue<std::string_view>() or GetValue<std::string>().
+         */
         template<typename T>
         const T& GetValueRef() const
         {
-            return const_cast<JsonVariant&>( *this ).GetValueRef<T>();
+            static_assert( !std::is_same_v<std::decay_t<T>, std::string_view> && !std::is_same_v<std::decay_t<T>, std::string>,
+                           "read strings with GetValue<std::string_view>() or GetValue<std::string>()" );
+
+            static const T kEmpty {};
+
+            if ( !IsA<std::decay_t<T>>() ) {
+                return kEmpty;
+            }
+
+            if constexpr ( std::is_same_v<std::decay_t<T>, JsonElement> || std::is_same_v<std::decay_t<T>, std::vector<JsonVariant>> ) {
+                return Boxed<std::decay_t<T>>();
+            }
+            else if constexpr ( std::is_same_v<std::decay_t<T>, sEmptyValue> ) {
+                return kEmpty;
+            }
+            else if constexpr ( IsValidType<std::decay_t<T>>() ) {
+                return Stored<std::decay_t<T>>();
+            }
+            else {
+                return kEmpty;
+            }
         }
 
+        /*!
+         * GetValueRef<std::string>() turns any other string into a std::string
+         * first, read strings with GetValue<std::string_view>() to keep them
+         * as they are.
+         */
         template<typename T>
         T& GetValueRef()
         {
+            static_assert( !std::is_same_v<std::decay_t<T>, std::string_view>, "read strings with GetValue<std::string_view>()" );
+
             static T kEmpty {};
 
             if ( !IsA<std::decay_t<T>>() ) {
                 return kEmpty;
             }
 
-            if constexpr ( IsValidType<std::decay_t<T>>() ) {
-                return std::get<std::decay_t<T>>( Value );
+            if constexpr ( std::is_same_v<std::decay_t<T>, std::string> ) {
+                if ( mType != eType::String ) {
+                    std::string lText( Text() );
+                    Reset();
+                    StoreBox( eType::String, MakeBox<std::string>( std::move( lText ) ) );
+                }
+
+                return Boxed<std::string>();
+            }
+            else if constexpr ( std::is_same_v<std::decay_t<T>, JsonElement> || std::is_same_v<std::decay_t<T>, std::vector<JsonVariant>> ) {
+                return Boxed<std::decay_t<T>>();
+            }
+            else if constexpr ( std::is_same_v<std::decay_t<T>, sEmptyValue> ) {
+                return kEmpty;
+            }
+            else if constexpr ( IsValidType<std::decay_t<T>>() ) {
+                return Stored<std::decay_t<T>>();
             }
             else {
                 return kEmpty;
             }
         }
 
-        JsonVariant& operator []( const std::string& aKey )
+        /*!
+         * Calls aFunc with the value, strings of any kind as a std::string_view
+         * and no value as sEmptyValue.
+         */
+        template<typename FUNC>
+        void Visit( FUNC&& aFunc ) const
         {
-            if ( std::holds_alternative<JsonElement>( Value ) ) {
-                JsonVariant& lVariant = std::get<JsonElement>( Value )[ aKey ];
-                return lVariant;
+            switch ( mType ) {
+                case eType::Int32:
+                    aFunc( Stored<int32_t>() );
+                    break;
+
+                case eType::UInt32:
+                    aFunc( Stored<uint32_t>() );
+                    break;
+
+                case eType::Int64:
+                    aFunc( Stored<int64_t>() );
+                    break;
+
+                case eType::UInt64:
+                    aFunc( Stored<uint64_t>() );
+                    break;
+
+                case eType::Bool:
+                    aFunc( Stored<bool>() );
+                    break;
+
+                case eType::Double:
+                    aFunc( Stored<double>() );
+                    break;
+
+                case eType::ShortString:
+                case eType::Text:
+                case eType::String:
+                case eType::BorrowedString:
+                    aFunc( Text() );
+                    break;
+
+                case eType::Object:
+                    aFunc( Boxed<JsonElement>() );
+                    break;
+
+                case eType::Array:
+                    aFunc( Boxed<std::vector<JsonVariant>>() );
+                    break;
+
+                default:
+                    aFunc( sEmptyValue {} );
+                    break;
             }
+        }
 
-            Value                 = JsonElement {};
-            JsonVariant& lVariant = std::get<JsonElement>( Value )[ aKey ];
-            return lVariant;
+        JsonVariant& operator []( const JsonKey& aKey )
+        {
+            if ( mType != eType::Object ) {
+                *this = JsonVariant( JsonElement {} );
+            }
+
+            return Boxed<JsonElement>()[ aKey ];
+        }
+
+        /*!
+         * Searches members by text, a key is only built for a new member.
+         */
+        template<typename K, typename = JsonElement::IfText<K>>
+        JsonVariant& operator []( const K& aText )
+        {
+            if ( mType != eType::Object ) {
+                *this = JsonVariant( JsonElement {} );
+            }
+
+            return Boxed<JsonElement>()[ aText ];
+        }
+
+    private:
+        /*!
+         * Block holding a string, object or array, it remembers the resource
+         * it came from since the current one may differ when it is freed.
+         */
+        template<typename T>
+        struct sBox final
+        {
+            std::pmr::memory_resource* Resource;
+            T                          Value;
+        };
+
+        /*!
+         * Header of the block of a Text string, the characters follow it.
+         */
+        struct sTextBlock final
+        {
+            std::pmr::memory_resource* Resource;
+        };
+
+        template<typename T>
+        static constexpr eType TypeOf()
+        {
+            if constexpr ( std::is_same_v<T, int32_t> ) {
+                return eType::Int32;
+            }
+            else if constexpr ( std::is_same_v<T, uint32_t> ) {
+                return eType::UInt32;
+            }
+            else if constexpr ( std::is_same_v<T, int64_t> ) {
+                return eType::Int64;
+            }
+            else if constexpr ( std::is_same_v<T, uint64_t> ) {
+                return eType::UInt64;
+            }
+            else if constexpr ( std::is_same_v<T, bool> ) {
+                return eType::Bool;
+            }
+            else if constexpr ( std::is_same_v<T, double> ) {
+                return eType::Double;
+            }
+            else if constexpr ( std::is_same_v<T, JsonElement> ) {
+                return eType::Object;
+            }
+            else if constexpr ( std::is_same_v<T, std::vector<JsonVariant>> ) {
+                return eType::Array;
+            }
+            else {
+                return eType::Empty;
+            }
         }
+
+        template<typename T, typename... ARGS>
+        static sBox<T>* MakeBox( ARGS&&... aArgs )
+        {
+            std::pmr::memory_resource* lResource = arena::Current();
+            void*                      lMemory   = lResource->allocate( sizeof( sBox<T> ), alignof( sBox<T> ) );
+
+            try {
+                return new ( lMemory ) sBox<T> { lResource, T( std::forward<ARGS>( aArgs )... ) };
+            }
+            catch ( ... ) {
+                lResource->deallocate( lMemory, sizeof( sBox<T> ), alignof( sBox<T> ) );
+                throw;
+            }
+        }
+
+        template<typename T>
+        static void FreeBox( sBox<T>* aBox )
+        {
+            std::pmr::memory_resource* lResource = aBox->Resource;
+
+            aBox->~sBox<T>();
+            lResource->deallocate( aBox, sizeof( sBox<T> ), alignof( sBox<T> ) );
+        }
+
+        template<typename T>
+        T& Stored()
+        {
+            return *std::launder( reinterpret_cast<T*>( mData ) );
+        }
+
+        template<typename T>
+        const T& Stored() const
+        {
+            return *std::launder( reinterpret_cast<const T*>( mData ) );
+        }
+
+        template<typename T>
+        T& Boxed()
+        {
+            return Stored<sBox<T>*>()->Value;
+        }
+
+        template<typename T>
+        const T& Boxed() const
+        {
+            return Stored<sBox<T>*>()->Value;
+        }
+
+        template<typename T>
+        void Store( const eType aType,
+                    const T     aValue )
+        {
+            new ( mData ) T( aValue );
+            mType = aType;
+        }
+
+        template<typename T>
+        void StoreBox( const eType aType,
+                       sBox<T>*    aBox )
+        {
+            new ( mData ) sBox<T>*( aBox );
+            mType = aType;
+        }
+
+        /*!
+         * Size of a Text or borrowed string, kept behind the pointer.
+         */
+        void StoreSize( const size_t aSize )
+        {
+            const uint32_t lSize = static_cast<uint32_t>( aSize );
+            std::memcpy( mData + sizeof( void* ), &lSize, sizeof( lSize ) );
+        }
+
+        size_t StoredSize() const
+        {
+            uint32_t lSize = 0;
+            std::memcpy( &lSize, mData + sizeof( void* ), sizeof( lSize ) );
+            return lSize;
+        }
+
+        void StoreText( const std::string_view aText )
+        {
+            if ( aText.size() <= kShortSize ) {
+                std::memcpy( mData, aText.data(), aText.size() );
+                mData[ kShortSize ] = static_cast<unsigned char>( aText.size() );
+                mType               = eType::ShortString;
+                return;
+            }
+
+            if ( aText.size() > std::numeric_limits<uint32_t>::max() ) {
+                StoreBox( eType::String, MakeBox<std::string>( aText ) );
+                return;
+            }
+
+            std::pmr::memory_resource* lResource = arena::Current();
+            void*                      lMemory   = lResource->allocate( sizeof( sTextBlock ) + aText.size(), alignof( sTextBlock ) );
+            sTextBlock*                lBlock    = new ( lMemory ) sTextBlock { lResource };
+
+            std::memcpy( lBlock + 1, aText.data(), aText.size() );
+            new ( mData ) sTextBlock*( lBlock );
+            StoreSize( aText.size() );
+            mType = eType::Text;
+        }
+
+        std::string_view Text() const
+        {
+            switch ( mType ) {
+                case eType::ShortString:
+                    return std::string_view( reinterpret_cast<const char*>( mData ), mData[ kShortSize ] );
+
+                case eType::Text:
+                    return std::string_view( reinterpret_cast<const char*>( Stored<sTextBlock*>() + 1 ), StoredSize() );
+
+                case eType::String:
+                    return Boxed<std::string>();
+
+                case eType::BorrowedString:
+                    return std::string_view( Stored<const char*>(), StoredSize() );
+
+                default:
+                    return {};
+            }
+        }
+
+        /*!
+         * Copies aOther into this empty value, blocks come from the current
+         * resource.
+         */
+        void CopyFrom( const JsonVariant& aOther )
+        {
+            switch ( aOther.mType ) {
+                case eType::Text:
+                    StoreText( aOther.Text() );
+                    break;
+
+                case eType::String:
+                    StoreBox( eType::String, MakeBox<std::string>( aOther.Boxed<std::string>() ) );
+                    break;
+
+                case eType::Object:
+                    StoreBox( eType::Object, MakeBox<JsonElement>( aOther.Boxed<JsonElement>() ) );
+                    break;
+
+                case eType::Array:
+                    StoreBox( eType::Array, MakeBox<std::vector<JsonVariant>>( aOther.Boxed<std::vector<JsonVariant>>() ) );
+                    break;
+
+                default:
+                    std::memcpy( mData, aOther.mData, sizeof( mData ) );
+                    mType = aOther.mType;
+                    break;
+            }
+        }
+
+        void Reset()
+        {
+            switch ( mType ) {
+                case eType::Text:
+                {
+                    sTextBlock* lBlock = Stored<sTextBlock*>();
+                    lBlock->Resource->deallocate( lBlock, sizeof( sTextBlock ) + StoredSize(), alignof( sTextBlock ) );
+                    break;
+                }
+
+                case eType::String:
+                    FreeBox( Stored<sBox<std::string>*>() );
+                    break;
+
+                case eType::Object:
+                    FreeBox( Stored<sBox<JsonElement>*>() );
+                    break;
+
+                case eType::Array:
+                    FreeBox( Stored<sBox<std::vector<JsonVariant>>*>() );
+                    break;
+
+                default:
+                    break;
+            }
+
+            mType = eType::Empty;
+        }
+
+    private:
+        unsigned char mData[ 15 ];            /*!<inline value or block pointer, then the size of Text and borrowed strings*/
+        eType         mType = eType::Empty;
     };
+
+    static_assert( sizeof( JsonVariant ) == 16, "JsonVariant is meant to stay 16 bytes" );
 }
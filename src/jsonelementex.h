@@ -4,7 +4,10 @@
 #include "jsonelement.h"
 #include "frommap.h"
 #include "parser.h"
+#include "structuralindex.h"
+#include "mappedfile.h"
 #include "mapparsernotifier.h"
+#include "mapviewparsernotifier.h"
 
 namespace jsbjson
 {
@@ -19,12 +22,88 @@ namespace jsbjson
             return FromMap {}( *this );
         }
 
-        bool FromJson( const std::string& aJsonString )
+        bool FromJson( const char*  aData,
+                       const size_t aSize )
+        {
+            return FromJson( std::string_view( aData, aSize ) );
+        }
+
+        bool FromJson( const std::string_view aJsonString )
+        {
+            StructuralIndex lIndex;
+            lIndex.Build( aJsonString );
+            return FromJson( aJsonString, lIndex );
+        }
+
+        bool FromJsonFile( const std::string& aPath )
+        {
+            const MappedFile lFile( aPath );
+
+            if ( !lFile.IsOpen() ) {
+                clear();
+                return false;
+            }
+
+            return FromJson( lFile.View() );
+        }
+
+        bool FromJson( const std::string_view aJsonString,
+                       const StructuralIndex& aIndex )
         {
             clear();
-            jsbjson::JsonParser lParser;
+            jsbjson::MapParserNotifier                            lNotifier( *this );
+            jsbjson::BasicJsonParser<jsbjson::MapParserNotifier>& lParser = jsbjson::BasicJsonParser<jsbjson::MapParserNotifier>::ForThread();
 
-            return lParser.Parse( aJsonString, std::make_shared<jsbjson::MapParserNotifier>( *this ) );
+            return lParser.Parse( aJsonString, aIndex, lNotifier );
+        }
+
+        /*!
+         * Interns the keys into aKeys, pass the same table for a stream of
+         * documents with the same keys to store each key once.
+         */
+        bool FromJson( const std::string_view aJsonString,
+                       KeyTable&              aKeys )
+        {
+            clear();
+            StructuralIndex                                       lIndex;
+            jsbjson::MapParserNotifier                            lNotifier( *this, aKeys );
+            jsbjson::BasicJsonParser<jsbjson::MapParserNotifier>& lParser = jsbjson::BasicJsonParser<jsbjson::MapParserNotifier>::ForThread();
+
+            lIndex.Build( aJsonString );
+            return lParser.Parse( aJsonString, lIndex, lNotifier );
+        }
+
+        /*!
+         * Keeps the string values that need no unescaping as views into
+         * aJsonString instead of copying them, so aJsonString must outlive
+         * this element and every value copied out of it.
+         */
+        bool FromJsonBorrowed( const std::string_view aJsonString )
+        {
+            StructuralIndex lIndex;
+            lIndex.Build( aJsonString );
+            return FromJsonBorrowed( aJsonString, lIndex );
+        }
+
+        bool FromJsonBorrowed( const std::string_view aJsonString,
+                               const StructuralIndex& aIndex )
+        {
+            clear();
+            jsbjson::MapViewParserNotifier                            lNotifier( *this, aJsonString );
+            jsbjson::BasicJsonParser<jsbjson::MapViewParserNotifier>& lParser = jsbjson::BasicJsonParser<jsbjson::MapViewParserNotifier>::ForThread();
+
+            return lParser.Parse( aJsonString, aIndex, lNotifier );
+        }
+
+        /*!
+         * Builds the document in aArena, which must outlive this element. Many
+         * documents can share an arena and are freed together by releasing it.
+         */
+        bool FromJson( const std::string_view aJsonString,
+                       JsonArena&             aArena )
+        {
+            const ArenaScope lScope( aArena );
+            return FromJson( aJsonString );
         }
     };
 }
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <charconv>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "iparserviewnotifier.h"
+#include "parser.h"
+#include "jsonpointer.h"
+#include "jsonstring.h"
+
+namespace jsbjson
+{
+    /*!
+     * Rewrites a document keeping or dropping values by path, straight from the
+     * parser events to the output, so no DOM is built and keys keep their
+     * order. Rules are JSON Pointers where a "*" token matches any key or
+     * index. With include rules only the included values and the containers
+     * leading to them are written, exclude rules drop values in any case.
+     * Strings are written re-escaped, numbers in their shortest exact form.
+     */
+    class JsonFilter final
+    {
+    public:
+        using Sink = std::function<void( std::string_view )>;
+
+        JsonFilter( const std::vector<std::string>& aInclude,
+                    const std::vector<std::string>& aExclude )
+            : mHandler( aInclude, aExclude )
+        {}
+
+        bool Filter( const std::string_view aJsonDocument,
+                     std::string&           aOutput )
+        {
+            mHandler.SetSink( nullptr );
+
+            const bool lSuccess = mParser.Parse( aJsonDocument, mHandler );
+            aOutput = mHandler.TakeOutput();
+            return lSuccess;
+        }
+
+        /*!
+         * Streaming use, the output is handed to aSink in pieces as it is
+         * written, so memory stays the same whatever the document size. When
+         * Feed() or Finish() fail the output so far is incomplete.
+         */
+        bool Start( Sink aSink )
+        {
+            mHandler.SetSink( std::move( aSink ) );
+            return mParser.Start( mHandler );
+        }
+
+        bool Feed( const std::string_view aChunk )
+        {
+            return mParser.Feed( aChunk );
+        }
+
+        bool Finish()
+        {
+            return mParser.Finish();
+        }
+
+    private:
+        struct Rule final
+        {
+            std::vector<pointer::Token> Tokens;
+            bool                        Exclude = false;
+        };
+
+        struct Frame final
+        {
+            bool        IsArray   = false;
+            bool        Opened    = false;   /*!<written yet, a container is only written once it holds something*/
+            bool        HasItems  = false;
+            bool        Included  = false;   /*!<everything below is kept unless excluded*/
+            size_t      NextIndex = 0;
+            size_t      LiveBegin = 0;       /*!<rules still matching, a range of mLive*/
+            std::string Key;                 /*!<kept for a container not written yet*/
+        };
+
+        enum class eKeep
+        {
+            Drop
+            , Partial
+            , Keep
+        };
+
+        class Handler final : public IParserViewNotifier
+        {
+        public:
+            Handler( const std::vector<std::string>& aInclude,
+                     const std::vector<std::string>& aExclude )
+            {
+                AddRules( aInclude, false );
+                AddRules( aExclude, true );
+            }
+
+            void SetSink( Sink aSink )
+            {
+                mSink = std::move( aSink );
+            }
+
+            std::string TakeOutput()
+            {
+                return std::move( mOutput );
+            }
+
+            void OnParsingStarted() override
+            {
+                mOutput.clear();
+                mFrames.clear();
+                mLive.clear();
+                mSkipDepth = 0;
+            }
+
+            void OnObjectBegin( const size_t           aID,
+                                const size_t           aParentID,
+                                const std::string_view aName ) override
+            {
+                BeginContainer( false, aName );
+            }
+
+            void OnObjectFinished( const size_t aID ) override
+            {
+                EndContainer();
+            }
+
+            void OnItemBegin( const size_t aParentID ) override
+            {}
+
+            void OnItemName( const std::string_view aName,
+                             const size_t           aParentID ) override
+            {}
+
+            void OnItemValueBegin( const eValueType aType ) override
+            {}
+
+            void OnItemValue( const Value&           aValue,
+                              const size_t           aParentID,
+                              const std::string_view aName ) override
+            {
+                if ( mSkipDepth != 0 ) {
+                    return;
+                }
+
+                const size_t lLiveBegin = mLive.size();
+                const eKeep  lKeep      = MatchChild( aName );
+                mLive.resize( lLiveBegin );
+
+                if ( lKeep != eKeep::Keep ) {
+                    return;
+                }
+
+                WriteItemStart( aName );
+                WriteValue( aValue );
+                MaybeFlush();
+            }
+
+            void OnArrayBegin( const size_t           aID,
+                               const size_t           aParentID,
+                               const std::string_view aName ) override
+            {
+                BeginContainer( true, aName );
+            }
+
+            void OnNextItem() override
+            {}
+
+            void OnArrayFinished( const size_t aID ) override
+            {
+                EndContainer();
+            }
+
+            void OnParsingFinished() override
+            {
+                if ( mSink && !mOutput.empty() ) {
+                    mSink( mOutput );
+                    mOutput.clear();
+                }
+            }
+
+            void OnError( const std::string& aError ) override
+            {}
+
+        private:
+            static constexpr size_t kFlushSize = 64 * 1024;
+
+            void AddRules( const std::vector<std::string>& aPointers,
+                           const bool                      aExclude )
+            {
+                for ( const std::string& lPointer : aPointers ) {
+                    Rule lRule;
+                    lRule.Exclude = aExclude;
+
+                    // malformed rules are ignored, "" would select the root which is always written
+                    if ( pointer::Parse( lPointer, lRule.Tokens, true ) && !lRule.Tokens.empty() ) {
+                        mIncludeCount += aExclude
+                                         ? 0
+                                         : 1;
+                        mRules.push_back( std::move( lRule ) );
+                    }
+                }
+            }
+
+            /*!
+             * Decides what happens to the next child of the current frame and
+             * appends the rules continuing below it to mLive.
+             */
+            eKeep MatchChild( const std::string_view aName )
+            {
+                Frame&       lFrame    = mFrames.back();
+                const size_t lDepth    = mFrames.size() - 1;
+                const size_t lLiveEnd  = mLive.size();
+                const size_t lPosition = lFrame.IsArray
+                                         ? lFrame.NextIndex++
+                                         : 0;
+                bool         lIncluded = lFrame.Included;
+                bool         lPartial  = false;
+
+                for ( size_t lIndex = lFrame.LiveBegin; lIndex < lLiveEnd; ++lIndex ) {
+                    const Rule& lRule = mRules[ mLive[ lIndex ] ];
+
+                    if ( !lRule.Tokens[ lDepth ].Matches( lFrame.IsArray, lPosition, aName ) ) {
+                        continue;
+                    }
+
+                    const bool lLast = lRule.Tokens.size() == lDepth + 1;
+
+                    if ( lRule.Exclude ) {
+                        if ( lLast ) {
+                            return eKeep::Drop;
+                        }
+
+                        mLive.push_back( mLive[ lIndex ] );
+                    }
+                    else if ( lLast ) {
+                        lIncluded = true;
+                    }
+                    else if ( !lFrame.Included ) {
+                        lPartial = true;
+                        mLive.push_back( mLive[ lIndex ] );
+                    }
+                }
+
+                if ( lIncluded ) {
+                    return eKeep::Keep;
+                }
+
+                return lPartial
+                       ? eKeep::Partial
+                       : eKeep::Drop;
+            }
+
+            void BeginContainer( const bool             aIsArray,
+                                 const std::string_view aName )
+            {
+                if ( mSkipDepth != 0 ) {
+                    ++mSkipDepth;
+                    return;
+                }
+
+                // the root is always written, the rules apply below it
+                if ( mFrames.empty() ) {
+                    mOutput += '{';
+                    mFrames.push_back( { aIsArray, true, false, mIncludeCount == 0, 0, 0, {} } );
+
+                    for ( size_t lIndex = 0; lIndex < mRules.size(); ++lIndex ) {
+                        mLive.push_back( lIndex );
+                    }
+
+                    return;
+                }
+
+                const size_t lLiveBegin = mLive.size();
+                const eKeep  lKeep      = MatchChild( aName );
+
+                if ( lKeep == eKeep::Drop ) {
+                    mLive.resize( lLiveBegin );
+                    mSkipDepth = 1;
+                    return;
+                }
+
+                if ( lKeep == eKeep::Keep ) {
+                    WriteItemStart( aName );
+                    mOutput += aIsArray
+                               ? '['
+                               : '{';
+                    mFrames.push_back( { aIsArray, true, false, true, 0, lLiveBegin, {} } );
+                    return;
+                }
+
+                mFrames.push_back( { aIsArray, false, false, false, 0, lLiveBegin, std::string( aName ) } );
+            }
+
+            void EndContainer()
+            {
+                if ( mSkipDepth != 0 ) {
+                    --mSkipDepth;
+                    return;
+                }
+
+                const Frame& lFrame = mFrames.back();
+
+                if ( lFrame.Opened ) {
+                    mOutput += lFrame.IsArray
+                               ? ']'
+                               : '}';
+                }
+
+                mLive.resize( lFrame.LiveBegin );
+                mFrames.pop_back();
+                MaybeFlush();
+            }
+
+            /*!
+             * Writes the separator and key of a kept child, first writing the
+             * containers above it that were held back.
+             */
+            void WriteItemStart( const std::string_view aName )
+            {
+                size_t lFirstClosed = mFrames.size();
+
+                while ( ( lFirstClosed > 0 ) && !mFrames[ lFirstClosed - 1 ].Opened ) {
+                    --lFirstClosed;
+                }
+
+                for ( size_t lIndex = lFirstClosed; lIndex < mFrames.size(); ++lIndex ) {
+                    Frame& lFrame = mFrames[ lIndex ];
+                    WriteKey( mFrames[ lIndex - 1 ], lFrame.Key );
+                    mOutput += lFrame.IsArray
+                               ? '['
+                               : '{';
+                    lFrame.Opened = true;
+                }
+
+                WriteKey( mFrames.back(), aName );
+            }
+
+            void WriteKey( Frame&                 aParent,
+                           const std::string_view aName )
+            {
+                if ( aParent.HasItems ) {
+                    mOutput += ',';
+                }
+
+                aParent.HasItems = true;
+
+                if ( !aParent.IsArray ) {
+                    mOutput += '\"';
+                    text::AppendEscaped( mOutput, aName );
+                    mOutput += "\":";
+                }
+            }
+
+            void WriteValue( const Value& aValue )
+            {
+                std::visit( [ this ] ( const auto aItem )
+                            {
+                                using ItemT = std::decay_t<decltype( aItem )>;
+
+                                if constexpr ( std::is_same_v<ItemT, std::string_view> ) {
+                                    mOutput += '\"';
+                                    text::AppendEscaped( mOutput, aItem );
+                                    mOutput += '\"';
+                                }
+                                else if constexpr ( std::is_same_v<ItemT, bool> ) {
+                                    mOutput += aItem
+                                               ? "true"
+                                               : "false";
+                                }
+                                else {
+                                    char       lBuffer[ 32 ];
+                                    const auto lResult = std::to_chars( lBuffer, lBuffer + sizeof( lBuffer ), aItem );
+                                    mOutput.append( lBuffer, lResult.ptr );
+
+                                    // a double must not read back as an integer
+                                    if constexpr ( std::is_same_v<ItemT, double> ) {
+                                        if ( std::string_view( lBuffer, lResult.ptr - lBuffer ).find_first_of( ".e" ) == std::string_view::npos ) {
+                                            mOutput += ".0";
+                                        }
+                                    }
+                                }
+                            }, aValue );
+            }
+
+            void MaybeFlush()
+            {
+                if ( mSink && ( mOutput.size() >= kFlushSize ) ) {
+                    mSink( mOutput );
+                    mOutput.clear();
+                }
+            }
+
+        private:
+            std::vector<Rule>   mRules;
+            size_t              mIncludeCount = 0;
+            Sink                mSink;
+            std::string         mOutput;
+            std::vector<Frame>  mFrames;
+            std::vector<size_t> mLive;
+            size_t              mSkipDepth = 0;
+        };
+
+    private:
+        Handler                  mHandler;
+        BasicJsonParser<Handler> mParser;
+    };
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace jsbjson
+{
+    /*!
+     * Object key sharing its text. Copies of a key, and keys interned by the
+     * same KeyTable, point to one string, so a key repeated in every item of a
+     * large array is stored once. Keys compare equal by pointer first and by
+     * text otherwise, keys built from a string are not interned.
+     */
+    class JsonKey final
+    {
+    public:
+        JsonKey()
+            : mText( Empty() )
+        {}
+
+        JsonKey( const char* aText )
+            : mText( std::make_shared<const std::string>( aText ) )
+        {}
+
+        JsonKey( const std::string_view aText )
+            : mText( std::make_shared<const std::string>( aText ) )
+        {}
+
+        JsonKey( const std::string& aText )
+            : mText( std::make_shared<const std::string>( aText ) )
+        {}
+
+        JsonKey( std::string&& aText )
+            : mText( std::make_shared<const std::string>( std::move( aText ) ) )
+        {}
+
+        const std::string& Str() const
+        {
+            return *mText;
+        }
+
+        operator const std::string&() const
+        {
+            return *mText;
+        }
+
+        bool operator ==( const JsonKey& aOther ) const
+        {
+            return ( mText == aOther.mText ) || ( *mText == *aOther.mText );
+        }
+
+        bool operator !=( const JsonKey& aOther ) const
+        {
+            return !( *this == aOther );
+        }
+
+        bool operator ==( const std::string_view aText ) const
+        {
+            return *mText == aText;
+        }
+
+        /*!
+         * Hashes keys and plain text alike, so maps can be searched by text
+         * without building a key.
+         */
+        struct Hash final
+        {
+            using is_transparent = void;
+
+            size_t operator ()( const JsonKey& aKey ) const
+            {
+                return std::hash<std::string_view> {}( *aKey.mText );
+            }
+
+            size_t operator ()( const std::string_view aText ) const
+            {
+                return std::hash<std::string_view> {}( aText );
+            }
+        };
+
+    private:
+        friend class KeyTable;
+
+        static const std::shared_ptr<const std::string>& Empty()
+        {
+            static const std::shared_ptr<const std::string> kEmpty = std::make_shared<const std::string>();
+            return kEmpty;
+        }
+
+        std::shared_ptr<const std::string> mText;
+    };
+
+    inline std::ostream& operator <<( std::ostream&  aStream,
+                                      const JsonKey& aKey )
+    {
+        return aStream << aKey.Str();
+    }
+
+    /*!
+     * Intern table handing out one JsonKey per distinct text. A table can serve
+     * a single document or be shared by many, keys stay valid after the table
+     * is cleared or destroyed. Not thread safe.
+     */
+    class KeyTable final
+    {
+    public:
+        const JsonKey& Intern( const std::string_view aText )
+        {
+            const auto lKeyIt = mKeys.find( aText );
+
+            if ( lKeyIt != mKeys.cend() ) {
+                return lKeyIt->second;
+            }
+
+            // the map is keyed by a view of the text the key owns
+            JsonKey lKey( aText );
+            const std::string_view lText = lKey.Str();
+            return mKeys.emplace( lText, std::move( lKey ) ).first->second;
+        }
+
+        size_t Size() const
+        {
+            return mKeys.size();
+        }
+
+        void Clear()
+        {
+            mKeys.clear();
+        }
+
+    private:
+        std::unordered_map<std::string_view, JsonKey> mKeys;
+    };
+
+    /*!
+     * Key for the Name() of a generated object or member, which is fixed per
+     * type, so the key is built once and shared by every element using it.
+     */
+    template<typename NAMED>
+    const JsonKey& KeyOf( const NAMED& aNamed )
+    {
+        static const JsonKey kKey( aNamed.Name() );
+        return kKey;
+    }
+}
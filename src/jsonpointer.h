@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsbjson
+{
+    namespace pointer
+    {
+        /*!
+         * One reference token of a JSON Pointer, decoded ("~1" is '/', "~0" is
+         * '~'). Tokens that are array indices also keep the index.
+         */
+        struct Token final
+        {
+            std::string Name;
+            size_t      Index    = std::string_view::npos;   /*!<the token as array index, npos if it is none*/
+            bool        Wildcard = false;                    /*!<"*", only set when parsed with aWildcards*/
+
+            bool Matches( const bool             aInArray,
+                          const size_t           aIndex,
+                          const std::string_view aName ) const
+            {
+                if ( Wildcard ) {
+                    return true;
+                }
+
+                return aInArray
+                       ? Index == aIndex
+                       : Name == aName;
+            }
+        };
+
+        /*!
+         * An array index token is "0" or digits without a leading zero.
+         */
+        inline size_t ToIndex( const std::string_view aToken )
+        {
+            if ( aToken.empty() || ( aToken.size() > 18 ) || ( ( aToken.front() == '0' ) && ( aToken.size() > 1 ) ) ) {
+                return std::string_view::npos;
+            }
+
+            size_t lIndex = 0;
+
+            for ( const char lChar : aToken ) {
+                if ( ( lChar < '0' ) || ( lChar > '9' ) ) {
+                    return std::string_view::npos;
+                }
+
+                lIndex = lIndex * 10 + static_cast<size_t>( lChar - '0' );
+            }
+
+            return lIndex;
+        }
+
+        /*!
+         * Splits an RFC 6901 pointer into its tokens, "" is the whole document.
+         * Returns false for a pointer not starting with '/' or a bad '~' escape.
+         * With aWildcards a "*" token matches any key or index.
+         */
+        inline bool Parse( const std::string_view aPointer,
+                           std::vector<Token>&    aTokens,
+                           const bool             aWildcards = false )
+        {
+            aTokens.clear();
+
+            if ( aPointer.empty() ) {
+                return true;
+            }
+
+            if ( aPointer.front() != '/' ) {
+                return false;
+            }
+
+            size_t lBegin = 1;
+
+            while ( true ) {
+                const size_t lEnd = std::min( aPointer.find( '/', lBegin ), aPointer.size() );
+                Token        lToken;
+
+                for ( size_t lIndex = lBegin; lIndex < lEnd; ++lIndex ) {
+                    if ( aPointer[ lIndex ] != '~' ) {
+                        lToken.Name += aPointer[ lIndex ];
+                    }
+                    else if ( ( lIndex + 1 < lEnd ) && ( ( aPointer[ lIndex + 1 ] == '0' ) || ( aPointer[ lIndex + 1 ] == '1' ) ) ) {
+                        lToken.Name += aPointer[ ++lIndex ] == '0'
+                                       ? '~'
+                                       : '/';
+                    }
+                    else {
+                        return false;
+                    }
+                }
+
+                lToken.Index    = ToIndex( lToken.Name );
+                lToken.Wildcard = aWildcards && ( aPointer.substr( lBegin, lEnd - lBegin ) == "*" );
+                aTokens.push_back( std::move( lToken ) );
+
+                if ( lEnd == aPointer.size() ) {
+                    return true;
+                }
+
+                lBegin = lEnd + 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,379 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "iparserviewnotifier.h"
+#include "structuralindex.h"
+#include "numberparser.h"
+#include "jsonstring.h"
+#include "parser.h"
+
+namespace jsbjson
+{
+    /*!
+     * Pull parser over the structural index, the caller asks for one event at
+     * a time and keeps its own state on the stack instead of implementing a
+     * notifier. Keys and string values are views into the document, or into a
+     * reader buffer when they hold escapes, valid until the next Next() call
+     * (Key() stays valid until the next key). Skip() passes over a subtree by
+     * counting brackets, skipped values are only checked for balanced brackets.
+     * Like the parser it takes objects as documents only, any other root is an
+     * Error, and nesting deeper than its maximum depth is an Error too.
+     */
+    class JsonReader final
+    {
+    public:
+        using Value = IParserViewNotifier::Value;
+
+        enum class eEvent
+        {
+            StartObject
+            , EndObject
+            , StartArray
+            , EndArray
+            , Key
+            , Value
+            , End
+            , Error
+        };
+
+        static constexpr size_t kDefaultMaxDepth = BasicJsonParser<IParserNotifier>::kDefaultMaxDepth;
+
+        explicit JsonReader( const size_t aMaxDepth = kDefaultMaxDepth )
+            : mMaxDepth( aMaxDepth )
+        {}
+
+        bool Start( const std::string_view aJsonDocument )
+        {
+            mOwnIndex.Build( aJsonDocument );
+            return Start( aJsonDocument, mOwnIndex );
+        }
+
+        bool Start( const std::string_view aJsonDocument,
+                    const StructuralIndex& aIndex )
+        {
+            mCursor.emplace( StructuralCursor { aJsonDocument, aIndex.Positions() } );
+            mContainers.clear();
+            mKey   = {};
+            mValue = Value {};
+            mEvent = eEvent::End;
+            mState = aIndex.IsFor( aJsonDocument ) && aIndex.IsComplete() && IsNext( '{' )
+                     ? eState::Value
+                     : eState::Failed;
+            return mState != eState::Failed;
+        }
+
+        /*!
+         * Returns the next event, End once the document is complete and Error
+         * from the first syntax error on. Both repeat on further calls.
+         */
+        eEvent Next()
+        {
+            switch ( mState ) {
+                case eState::Value:
+                    return mEvent = ReadValue();
+
+                case eState::FirstItem:
+                    return mEvent = IsNext( ']' )
+                                    ? CloseContainer()
+                                    : ReadValue();
+
+                case eState::FirstKey:
+                    return mEvent = IsNext( '}' )
+                                    ? CloseContainer()
+                                    : ReadKey();
+
+                case eState::AfterValue:
+                    return mEvent = ReadAfterValue();
+
+                case eState::Done:
+                    return mEvent = eEvent::End;
+
+                default:
+                    return mEvent = eEvent::Error;
+            }
+        }
+
+        /*!
+         * After StartObject or StartArray passes over the rest of the container
+         * including its closing bracket, after Key over the member's value, and
+         * does nothing otherwise. Afterwards the reader stands where the skipped
+         * value ended, as after its EndObject, EndArray or Value event, so a
+         * second Skip() does nothing. Returns false if the document is
+         * malformed.
+         */
+        bool Skip()
+        {
+            if ( ( mEvent == eEvent::StartObject ) || ( mEvent == eEvent::StartArray ) ) {
+                return SkipRest();
+            }
+
+            if ( mEvent != eEvent::Key ) {
+                return mState != eState::Failed;
+            }
+
+            if ( IsNext( '{' ) || IsNext( '[' ) ) {
+                if ( mContainers.size() >= mMaxDepth ) {
+                    Fail();
+                    return false;
+                }
+
+                mCursor->Advance();
+                mContainers.push_back( 0 );
+                return SkipRest();
+            }
+
+            mEvent = ReadValue();
+            return mEvent == eEvent::Value;
+        }
+
+        /*!
+         * Name of the last Key event.
+         */
+        std::string_view Key() const
+        {
+            return mKey;
+        }
+
+        /*!
+         * Value of the last Value event.
+         */
+        const Value& GetValue() const
+        {
+            return mValue;
+        }
+
+        /*!
+         * Number of containers open.
+         */
+        size_t Depth() const
+        {
+            return mContainers.size();
+        }
+
+    private:
+        enum class eState
+        {
+            Value
+            , FirstItem
+            , FirstKey
+            , AfterValue
+            , Done
+            , Failed
+        };
+
+        bool IsNext( const char aChar ) const
+        {
+            return !mCursor->AtEnd()
+                   && ( mCursor->Peek() == aChar )
+                   && mCursor->IsBlankUntil( mCursor->Offset() );
+        }
+
+        eEvent Fail()
+        {
+            mState = eState::Failed;
+            return eEvent::Error;
+        }
+
+        eEvent CloseContainer()
+        {
+            const char lClosing = mContainers.back();
+            mCursor->Advance();
+            mContainers.pop_back();
+            mState = eState::AfterValue;
+            return lClosing == '}'
+                   ? eEvent::EndObject
+                   : eEvent::EndArray;
+        }
+
+        /*!
+         * Reads the string starting at the cursor, decoding it into aBuffer when
+         * it holds escapes.
+         */
+        bool ReadString( std::string&      aBuffer,
+                         std::string_view& aText )
+        {
+            const size_t lBegin = mCursor->Offset();
+            mCursor->Advance();
+
+            if ( mCursor->AtEnd() ) {
+                return false;
+            }
+
+            aText = mCursor->Document.substr( lBegin + 1, mCursor->Offset() - lBegin - 1 );
+            mCursor->Advance();
+
+            if ( aText.find( '\\' ) == std::string_view::npos ) {
+                return true;
+            }
+
+            aBuffer.assign( aText.data(), aText.size() );
+
+            if ( !text::Unescape( aBuffer ) ) {
+                return false;
+            }
+
+            aText = aBuffer;
+            return true;
+        }
+
+        eEvent ReadKey()
+        {
+            if ( !IsNext( '\"' ) || !ReadString( mKeyBuffer, mKey ) || !IsNext( ':' ) ) {
+                return Fail();
+            }
+
+            mCursor->Advance();
+            mState = eState::Value;
+            return eEvent::Key;
+        }
+
+        eEvent ReadValue()
+        {
+            StructuralCursor& lCursor = *mCursor;
+            const size_t      lEnd    = lCursor.AtEnd()
+                                        ? lCursor.Document.size()
+                                        : lCursor.Offset();
+
+            if ( lCursor.IsBlankUntil( lEnd ) ) {
+                if ( lCursor.AtEnd() ) {
+                    return Fail();
+                }
+
+                const char lChar = lCursor.Peek();
+
+                if ( ( lChar == '{' ) || ( lChar == '[' ) ) {
+                    if ( mContainers.size() >= mMaxDepth ) {
+                        return Fail();
+                    }
+
+                    lCursor.Advance();
+                    mContainers.push_back( lChar == '{'
+                                           ? '}'
+                                           : ']' );
+                    mState = lChar == '{'
+                             ? eState::FirstKey
+                             : eState::FirstItem;
+                    return lChar == '{'
+                           ? eEvent::StartObject
+                           : eEvent::StartArray;
+                }
+
+                std::string_view lText;
+
+                if ( ( lChar != '\"' ) || !ReadString( mTextBuffer, lText ) ) {
+                    return Fail();
+                }
+
+                mValue = lText;
+                mState = eState::AfterValue;
+                return eEvent::Value;
+            }
+
+            // a literal runs up to the next structural
+            const std::string_view lLiteral = lCursor.Span( lCursor.After, lEnd );
+            lCursor.After = lEnd;
+
+            if ( ( lLiteral == "true" ) || ( lLiteral == "false" ) ) {
+                mValue = lLiteral == "true";
+            }
+            else {
+                const std::optional<number::Value> lNumber = number::Parse( lLiteral );
+
+                if ( !lNumber.has_value() ) {
+                    return Fail();
+                }
+
+                std::visit( [ this ] ( const auto aNumber )
+                            {
+                                mValue = aNumber;
+                            }, lNumber.value() );
+            }
+
+            mState = eState::AfterValue;
+            return eEvent::Value;
+        }
+
+        eEvent ReadAfterValue()
+        {
+            StructuralCursor& lCursor = *mCursor;
+
+            if ( mContainers.empty() ) {
+                if ( !lCursor.AtEnd() || !lCursor.IsBlankUntil( lCursor.Document.size() ) ) {
+                    return Fail();
+                }
+
+                mState = eState::Done;
+                return eEvent::End;
+            }
+
+            if ( IsNext( mContainers.back() ) ) {
+                return CloseContainer();
+            }
+
+            if ( !IsNext( ',' ) ) {
+                return Fail();
+            }
+
+            lCursor.Advance();
+
+            return mContainers.back() == '}'
+                   ? ReadKey()
+                   : ReadValue();
+        }
+
+        /*!
+         * The skipped container is the innermost of mContainers, lDepth counts
+         * it and the containers open inside it.
+         */
+        bool SkipRest()
+        {
+            StructuralCursor& lCursor = *mCursor;
+            size_t            lDepth  = 1;
+
+            while ( lDepth != 0 ) {
+                if ( lCursor.AtEnd() ) {
+                    Fail();
+                    return false;
+                }
+
+                const char lChar = lCursor.Peek();
+                lCursor.Advance();
+
+                if ( ( lChar == '{' ) || ( lChar == '[' ) ) {
+                    if ( mContainers.size() + lDepth > mMaxDepth ) {
+                        Fail();
+                        return false;
+                    }
+
+                    ++lDepth;
+                }
+                else if ( ( lChar == '}' ) || ( lChar == ']' ) ) {
+                    --lDepth;
+                    mEvent = lChar == '}'
+                             ? eEvent::EndObject
+                             : eEvent::EndArray;
+                }
+            }
+
+            mContainers.pop_back();
+            mState = eState::AfterValue;
+            return true;
+        }
+
+    private:
+        StructuralIndex                 mOwnIndex;
+        std::optional<StructuralCursor> mCursor;
+        std::vector<char>               mContainers;   /*!<closing bracket of each open container*/
+        std::string                     mKeyBuffer;
+        std::string                     mTextBuffer;
+        std::string_view                mKey;
+        Value                           mValue;
+        eEvent                          mEvent    = eEvent::End;
+        eState                          mState    = eState::Failed;
+        size_t                          mMaxDepth = kDefaultMaxDepth;
+    };
+}
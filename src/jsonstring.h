@@ -0,0 +1,406 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "structuralindex.h"
+
+namespace jsbjson
+{
+    namespace text
+    {
+        /*!
+         * Returns the first '"' or '\\' in [aCursor, aEnd) or aEnd. Strings without
+         * escapes are skipped 16 bytes at a time.
+         */
+        inline const char* FindQuoteOrBackslash( const char* aCursor,
+                                                 const char* aEnd )
+        {
+#if defined( JSBJSON_X64 )
+            const __m128i lQuote     = _mm_set1_epi8( '\"' );
+            const __m128i lBackslash = _mm_set1_epi8( '\\' );
+
+            while ( aEnd - aCursor >= 16 ) {
+                const __m128i  lChunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aCursor ) );
+                const uint32_t lMask  = static_cast<uint32_t>( _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( lChunk, lQuote ),
+                                                                                                 _mm_cmpeq_epi8( lChunk, lBackslash ) ) ) );
+
+                if ( lMask != 0 ) {
+                    return aCursor + simd::CountTrailingZeros( lMask );
+                }
+
+                aCursor += 16;
+            }
+#endif
+
+            for ( ; aCursor != aEnd; ++aCursor ) {
+                if ( ( *aCursor == '\"' ) || ( *aCursor == '\\' ) ) {
+                    return aCursor;
+                }
+            }
+
+            return aEnd;
+        }
+
+        inline bool ReadHex4( const char* aCursor,
+                              uint32_t&   aValue )
+        {
+            aValue = 0;
+
+            for ( size_t lIndex = 0; lIndex < 4; ++lIndex ) {
+                const char lChar = aCursor[ lIndex ];
+                aValue <<= 4;
+
+                if ( ( lChar >= '0' ) && ( lChar <= '9' ) ) {
+                    aValue |= static_cast<uint32_t>( lChar - '0' );
+                }
+                else if ( ( lChar >= 'a' ) && ( lChar <= 'f' ) ) {
+                    aValue |= static_cast<uint32_t>( lChar - 'a' + 10 );
+                }
+                else if ( ( lChar >= 'A' ) && ( lChar <= 'F' ) ) {
+                    aValue |= static_cast<uint32_t>( lChar - 'A' + 10 );
+                }
+                else {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        inline size_t WriteUtf8( const uint32_t aCodePoint,
+                                 char*          aOut )
+        {
+            if ( aCodePoint < 0x80 ) {
+                aOut[ 0 ] = static_cast<char>( aCodePoint );
+                return 1;
+            }
+
+            if ( aCodePoint < 0x800 ) {
+                aOut[ 0 ] = static_cast<char>( 0xC0 | ( aCodePoint >> 6 ) );
+                aOut[ 1 ] = static_cast<char>( 0x80 | ( aCodePoint & 0x3F ) );
+                return 2;
+            }
+
+            if ( aCodePoint < 0x10000 ) {
+                aOut[ 0 ] = static_cast<char>( 0xE0 | ( aCodePoint >> 12 ) );
+                aOut[ 1 ] = static_cast<char>( 0x80 | ( ( aCodePoint >> 6 ) & 0x3F ) );
+                aOut[ 2 ] = static_cast<char>( 0x80 | ( aCodePoint & 0x3F ) );
+                return 3;
+            }
+
+            aOut[ 0 ] = static_cast<char>( 0xF0 | ( aCodePoint >> 18 ) );
+            aOut[ 1 ] = static_cast<char>( 0x80 | ( ( aCodePoint >> 12 ) & 0x3F ) );
+            aOut[ 2 ] = static_cast<char>( 0x80 | ( ( aCodePoint >> 6 ) & 0x3F ) );
+            aOut[ 3 ] = static_cast<char>( 0x80 | ( aCodePoint & 0x3F ) );
+            return 4;
+        }
+
+        /*!
+         * Decodes the escape sequences of a raw string body in place, a decoded
+         * sequence is never longer than its escaped form. Returns false for
+         * unknown escapes, bad \u digits and unpaired surrogates.
+         */
+        inline bool Unescape( std::string& aText )
+        {
+            char*             lData  = aText.data();
+            const char* const lEnd   = lData + aText.size();
+            const char*       lRead  = static_cast<const char*>( std::memchr( lData, '\\', aText.size() ) );
+            char*             lWrite = const_cast<char*>( lRead );
+
+            if ( lRead == nullptr ) {
+                return true;
+            }
+
+            while ( lRead != lEnd ) {
+                if ( *lRead != '\\' ) {
+                    const char* lNext = static_cast<const char*>( std::memchr( lRead, '\\', lEnd - lRead ) );
+
+                    if ( lNext == nullptr ) {
+                        lNext = lEnd;
+                    }
+
+                    std::memmove( lWrite, lRead, lNext - lRead );
+                    lWrite += lNext - lRead;
+                    lRead   = lNext;
+                    continue;
+                }
+
+                if ( lEnd - lRead < 2 ) {
+                    return false;
+                }
+
+                const char lEscaped = lRead[ 1 ];
+                lRead += 2;
+
+                switch ( lEscaped ) {
+                    case '\"': *lWrite++ = '\"'; break;
+                    case '\\': *lWrite++ = '\\'; break;
+                    case '/': *lWrite++  = '/'; break;
+                    case 'b': *lWrite++  = '\b'; break;
+                    case 'f': *lWrite++  = '\f'; break;
+                    case 'n': *lWrite++  = '\n'; break;
+                    case 'r': *lWrite++  = '\r'; break;
+                    case 't': *lWrite++  = '\t'; break;
+                    case 'u':
+                    {
+                        uint32_t lCodePoint = 0;
+
+                        if ( ( lEnd - lRead < 4 ) || !ReadHex4( lRead, lCodePoint ) ) {
+                            return false;
+                        }
+
+                        lRead += 4;
+
+                        if ( ( lCodePoint >= 0xDC00 ) && ( lCodePoint <= 0xDFFF ) ) {
+                            return false;
+                        }
+
+                        if ( ( lCodePoint >= 0xD800 ) && ( lCodePoint <= 0xDBFF ) ) {
+                            uint32_t lLow = 0;
+
+                            if ( ( lEnd - lRead < 6 )
+                                 || ( lRead[ 0 ] != '\\' )
+                                 || ( lRead[ 1 ] != 'u' )
+                                 || !ReadHex4( lRead + 2, lLow )
+                                 || ( lLow < 0xDC00 )
+                                 || ( lLow > 0xDFFF ) )
+                            {
+                                return false;
+                            }
+
+                            lRead     += 6;
+                            lCodePoint = 0x10000 + ( ( lCodePoint - 0xD800 ) << 10 ) + ( lLow - 0xDC00 );
+                        }
+
+                        lWrite += WriteUtf8( lCodePoint, lWrite );
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+            }
+
+            aText.resize( static_cast<size_t>( lWrite - lData ) );
+            return true;
+        }
+
+        /*!
+         * Returns the offset of the first byte in a raw string body that makes it
+         * invalid JSON, an unescaped control character or a bad escape sequence,
+         * or npos. Text without either is skipped 16 bytes at a time.
+         */
+        inline size_t FindInvalid( const std::string_view aBody )
+        {
+            const char* const lBegin  = aBody.data();
+            const char* const lEnd    = lBegin + aBody.size();
+            const char*       lCursor = lBegin;
+
+            while ( lCursor != lEnd ) {
+#if defined( JSBJSON_X64 )
+                const __m128i lBackslash = _mm_set1_epi8( '\\' );
+                const __m128i lControl   = _mm_set1_epi8( 0x1F );
+
+                while ( lEnd - lCursor >= 16 ) {
+                    const __m128i  lChunk = _mm_loadu_si128( reinterpret_cast<const __m128i*>( lCursor ) );
+                    const __m128i  lLow   = _mm_cmpeq_epi8( _mm_max_epu8( lChunk, lControl ), lControl );
+                    const uint32_t lMask  = static_cast<uint32_t>( _mm_movemask_epi8( _mm_or_si128( lLow, _mm_cmpeq_epi8( lChunk, lBackslash ) ) ) );
+
+                    if ( lMask != 0 ) {
+                        lCursor += simd::CountTrailingZeros( lMask );
+                        break;
+                    }
+
+                    lCursor += 16;
+                }
+
+                if ( lCursor == lEnd ) {
+                    break;
+                }
+#endif
+                const unsigned char lChar = static_cast<unsigned char>( *lCursor );
+
+                if ( lChar < 0x20 ) {
+                    return static_cast<size_t>( lCursor - lBegin );
+                }
+
+                if ( lChar != '\\' ) {
+                    ++lCursor;
+                    continue;
+                }
+
+                const char* const lEscape = lCursor;
+
+                if ( lEnd - lCursor < 2 ) {
+                    return static_cast<size_t>( lEscape - lBegin );
+                }
+
+                const char lEscaped = lCursor[ 1 ];
+                lCursor += 2;
+
+                if ( ( lEscaped != '\0' ) && ( std::strchr( "\"\\/bfnrt", lEscaped ) != nullptr ) ) {
+                    continue;
+                }
+
+                uint32_t lCodePoint = 0;
+
+                if ( ( lEscaped != 'u' )
+                     || ( lEnd - lCursor < 4 )
+                     || !ReadHex4( lCursor, lCodePoint )
+                     || ( ( lCodePoint >= 0xDC00 ) && ( lCodePoint <= 0xDFFF ) ) )
+                {
+                    return static_cast<size_t>( lEscape - lBegin );
+                }
+
+                lCursor += 4;
+
+                if ( ( lCodePoint >= 0xD800 ) && ( lCodePoint <= 0xDBFF ) ) {
+                    uint32_t lLow = 0;
+
+                    if ( ( lEnd - lCursor < 6 )
+                         || ( lCursor[ 0 ] != '\\' )
+                         || ( lCursor[ 1 ] != 'u' )
+                         || !ReadHex4( lCursor + 2, lLow )
+                         || ( lLow < 0xDC00 )
+                         || ( lLow > 0xDFFF ) )
+                    {
+                        return static_cast<size_t>( lEscape - lBegin );
+                    }
+
+                    lCursor += 6;
+                }
+            }
+
+            return std::string_view::npos;
+        }
+
+        /*!
+         * Returns the offset of the first byte of an invalid UTF-8 sequence in
+         * aText (overlong forms, surrogates and code points above U+10FFFF
+         * included), or npos. ASCII is skipped 16 bytes at a time.
+         */
+        inline size_t FindInvalidUtf8( const std::string_view aText )
+        {
+            const unsigned char* const lData   = reinterpret_cast<const unsigned char*>( aText.data() );
+            const size_t               lSize   = aText.size();
+            size_t                     lOffset = 0;
+
+            while ( lOffset < lSize ) {
+#if defined( JSBJSON_X64 )
+                while ( ( lSize - lOffset >= 16 )
+                        && ( _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( lData + lOffset ) ) ) == 0 ) )
+                {
+                    lOffset += 16;
+                }
+
+                if ( lOffset == lSize ) {
+                    break;
+                }
+#endif
+                const unsigned char lLead = lData[ lOffset ];
+
+                if ( lLead < 0x80 ) {
+                    ++lOffset;
+                    continue;
+                }
+
+                size_t   lLength    = 0;
+                uint32_t lMinimum   = 0;
+                uint32_t lCodePoint = 0;
+
+                if ( ( lLead & 0xE0 ) == 0xC0 ) {
+                    lLength    = 2;
+                    lMinimum   = 0x80;
+                    lCodePoint = lLead & 0x1F;
+                }
+                else if ( ( lLead & 0xF0 ) == 0xE0 ) {
+                    lLength    = 3;
+                    lMinimum   = 0x800;
+                    lCodePoint = lLead & 0x0F;
+                }
+                else if ( ( lLead & 0xF8 ) == 0xF0 ) {
+                    lLength    = 4;
+                    lMinimum   = 0x10000;
+                    lCodePoint = lLead & 0x07;
+                }
+                else {
+                    return lOffset;
+                }
+
+                if ( lSize - lOffset < lLength ) {
+                    return lOffset;
+                }
+
+                for ( size_t lIndex = 1; lIndex < lLength; ++lIndex ) {
+                    const unsigned char lNext = lData[ lOffset + lIndex ];
+
+                    if ( ( lNext & 0xC0 ) != 0x80 ) {
+                        return lOffset;
+                    }
+
+                    lCodePoint = ( lCodePoint << 6 ) | ( lNext & 0x3F );
+                }
+
+                if ( ( lCodePoint < lMinimum )
+                     || ( lCodePoint > 0x10FFFF )
+                     || ( ( lCodePoint >= 0xD800 ) && ( lCodePoint <= 0xDFFF ) ) )
+                {
+                    return lOffset;
+                }
+
+                lOffset += lLength;
+            }
+
+            return std::string_view::npos;
+        }
+
+        /*!
+         * Appends aText with '"', '\\' and control characters escaped.
+         */
+        inline void AppendEscaped( std::string&           aOut,
+                                   const std::string_view aText )
+        {
+            constexpr char kHex[] = "0123456789abcdef";
+            size_t         lRun   = 0;
+
+            for ( size_t lIndex = 0; lIndex < aText.size(); ++lIndex ) {
+                const unsigned char lChar = static_cast<unsigned char>( aText[ lIndex ] );
+
+                if ( ( lChar >= 0x20 ) && ( lChar != '\"' ) && ( lChar != '\\' ) ) {
+                    continue;
+                }
+
+                aOut.append( aText.data() + lRun, lIndex - lRun );
+                lRun = lIndex + 1;
+
+                switch ( lChar ) {
+                    case '\"': aOut += "\\\""; break;
+                    case '\\': aOut += "\\\\"; break;
+                    case '\b': aOut += "\\b"; break;
+                    case '\f': aOut += "\\f"; break;
+                    case '\n': aOut += "\\n"; break;
+                    case '\r': aOut += "\\r"; break;
+                    case '\t': aOut += "\\t"; break;
+                    default:
+                        aOut += "\\u00";
+                        aOut += kHex[ lChar >> 4 ];
+                        aOut += kHex[ lChar & 0xF ];
+                        break;
+                }
+            }
+
+            aOut.append( aText.data() + lRun, aText.size() - lRun );
+        }
+
+        inline std::string Quote( const std::string_view aText )
+        {
+            std::string lResult;
+            lResult.reserve( aText.size() + 2 );
+            lResult += '\"';
+            AppendEscaped( lResult, aText );
+            lResult += '\"';
+            return lResult;
+        }
+    }
+}
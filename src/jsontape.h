@@ -0,0 +1,728 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "iparserviewnotifier.h"
+#include "parser.h"
+#include "structuralindex.h"
+#include "jsonelement.h"
+
+namespace jsbjson
+{
+    class JsonTape;
+    class TapeObject;
+    class TapeArray;
+
+    /*!
+     * Tags of the tape words, the tag is the top byte of a word.
+     */
+    enum class eTapeTag : uint8_t
+    {
+        Object      = '{'
+        , ObjectEnd = '}'
+        , Array     = '['
+        , ArrayEnd  = ']'
+        , String    = '\"'
+        , UInt      = 'u'
+        , Int       = 'i'
+        , Double    = 'd'
+        , True      = 't'
+        , False     = 'f'
+    };
+
+    /*!
+     * Cursor to one value of a JsonTape, just a pointer and an index. A default
+     * constructed value, or one a lookup did not find, is not valid and holds
+     * nothing. Typed access follows JsonVariant::GetValue, besides the stored
+     * type uint64_t and int64_t convert into each other when in range.
+     */
+    class TapeValue
+    {
+    public:
+        TapeValue() = default;
+
+        TapeValue( const JsonTape* aTape,
+                   const size_t    aIndex )
+            : mTape( aTape )
+            , mIndex( aIndex )
+        {}
+
+        bool IsValid() const
+        {
+            return mTape != nullptr;
+        }
+
+        bool IsObject() const
+        {
+            return IsValid() && ( Tag() == eTapeTag::Object );
+        }
+
+        bool IsArray() const
+        {
+            return IsValid() && ( Tag() == eTapeTag::Array );
+        }
+
+        template<typename T>
+        bool IsA() const
+        {
+            return GetValue<T>().has_value();
+        }
+
+        template<typename T>
+        std::optional<T> GetValue() const;
+
+        /*!
+         * Member of an object, see TapeObject::Find().
+         */
+        TapeValue operator []( const std::string_view aKey ) const;
+
+        /*!
+         * Item of an array, found by skipping the items before it.
+         */
+        TapeValue operator []( const size_t aIndex ) const;
+
+        /*!
+         * Copies the value and everything below it into the DOM types.
+         */
+        JsonVariant ToVariant() const;
+
+        eTapeTag Tag() const;
+
+    private:
+        const JsonTape* mTape  = nullptr;
+        size_t          mIndex = 0;
+    };
+
+    struct TapeMember final
+    {
+        std::string_view Key;
+        TapeValue        Value;
+    };
+
+    /*!
+     * Read-only document stored as one contiguous tape of tagged 64-bit words
+     * and a buffer with the string texts. An object or array word holds the
+     * index after its closing word, so a subtree is skipped in O(1), and the
+     * number of its items. Numbers take a second word with their bits, a
+     * string word holds the offset of its length prefixed text.
+     */
+    class JsonTape final
+    {
+    public:
+        bool Parse( const std::string_view aJsonDocument );
+
+        bool Parse( const std::string_view aJsonDocument,
+                    const StructuralIndex& aIndex );
+
+        void Clear()
+        {
+            mWords.clear();
+            mStrings.clear();
+        }
+
+        bool Empty() const
+        {
+            return mWords.empty();
+        }
+
+        TapeValue Root() const
+        {
+            return Empty()
+                   ? TapeValue {}
+                   : TapeValue( this, 0 );
+        }
+
+    private:
+        friend class TapeValue;
+        friend class TapeObject;
+        friend class TapeArray;
+        friend class TapeParserNotifier;
+
+        static constexpr uint64_t kCountMask   = ( uint64_t { 1 } << 24 ) - 1;   /*!<item count saturates here*/
+        static constexpr uint64_t kPayloadMask = ( uint64_t { 1 } << 56 ) - 1;
+
+        eTapeTag Tag( const size_t aIndex ) const
+        {
+            return static_cast<eTapeTag>( mWords[ aIndex ] >> 56 );
+        }
+
+        uint64_t Payload( const size_t aIndex ) const
+        {
+            return mWords[ aIndex ] & kPayloadMask;
+        }
+
+        uint64_t Bits( const size_t aIndex ) const
+        {
+            return mWords[ aIndex + 1 ];
+        }
+
+        /*!
+         * Index of the word after the value at aIndex.
+         */
+        size_t After( const size_t aIndex ) const
+        {
+            switch ( Tag( aIndex ) ) {
+                case eTapeTag::Object:
+                case eTapeTag::Array:
+                    return static_cast<size_t>( Payload( aIndex ) & 0xFFFFFFFF );
+
+                case eTapeTag::UInt:
+                case eTapeTag::Int:
+                case eTapeTag::Double:
+                    return aIndex + 2;
+
+                default:
+                    return aIndex + 1;
+            }
+        }
+
+        std::string_view Text( const size_t aIndex ) const
+        {
+            const size_t lOffset = static_cast<size_t>( Payload( aIndex ) );
+            uint32_t     lSize   = 0;
+            std::memcpy( &lSize, mStrings.data() + lOffset, sizeof( lSize ) );
+            return std::string_view( mStrings.data() + lOffset + sizeof( lSize ), lSize );
+        }
+
+        size_t Append( const eTapeTag aTag,
+                       const uint64_t aPayload )
+        {
+            mWords.push_back( ( static_cast<uint64_t>( aTag ) << 56 ) | aPayload );
+            return mWords.size() - 1;
+        }
+
+        void AppendBits( const uint64_t aBits )
+        {
+            mWords.push_back( aBits );
+        }
+
+        void AppendString( const std::string_view aText )
+        {
+            const uint32_t lSize = static_cast<uint32_t>( aText.size() );
+
+            Append( eTapeTag::String, mStrings.size() );
+            mStrings.append( reinterpret_cast<const char*>( &lSize ), sizeof( lSize ) );
+            mStrings.append( aText.data(), aText.size() );
+        }
+
+        void Close( const size_t   aOpen,
+                    const eTapeTag aTag,
+                    const size_t   aCount )
+        {
+            const size_t lClose = Append( aTag, aOpen );
+            mWords[ aOpen ] = ( mWords[ aOpen ] & ~kPayloadMask )
+                              | ( std::min<uint64_t>( aCount, kCountMask ) << 32 )
+                              | ( lClose + 1 );
+        }
+
+        std::vector<uint64_t> mWords;
+        std::string           mStrings;
+    };
+
+    /*!
+     * Members of a tape object in document order.
+     */
+    class TapeObject final
+    {
+    public:
+        class Iterator final
+        {
+        public:
+            Iterator( const JsonTape* aTape,
+                      const size_t    aIndex )
+                : mTape( aTape )
+                , mIndex( aIndex )
+            {}
+
+            TapeMember operator *() const
+            {
+                return { mTape->Text( mIndex ), TapeValue( mTape, mIndex + 1 ) };
+            }
+
+            Iterator& operator ++()
+            {
+                mIndex = mTape->After( mIndex + 1 );
+                return *this;
+            }
+
+            bool operator !=( const Iterator& aOther ) const
+            {
+                return mIndex != aOther.mIndex;
+            }
+
+        private:
+            const JsonTape* mTape;
+            size_t          mIndex;
+        };
+
+        TapeObject() = default;
+
+        TapeObject( const JsonTape* aTape,
+                    const size_t    aIndex )
+            : mTape( aTape )
+            , mIndex( aIndex )
+        {}
+
+        Iterator begin() const
+        {
+            return mTape == nullptr
+                   ? Iterator( nullptr, 0 )
+                   : Iterator( mTape, mIndex + 1 );
+        }
+
+        Iterator end() const
+        {
+            return mTape == nullptr
+                   ? Iterator( nullptr, 0 )
+                   : Iterator( mTape, mTape->After( mIndex ) - 1 );
+        }
+
+        size_t size() const
+        {
+            return Count( mTape, mIndex, *this );
+        }
+
+        /*!
+         * Member with aKey, of duplicate keys the last one wins as in the DOM.
+         */
+        TapeValue Find( const std::string_view aKey ) const
+        {
+            TapeValue lResult;
+
+            for ( const TapeMember lMember : *this ) {
+                if ( lMember.Key == aKey ) {
+                    lResult = lMember.Value;
+                }
+            }
+
+            return lResult;
+        }
+
+        /*!
+         * Item count, read from the open word unless it saturated.
+         */
+        template<typename RANGE>
+        static size_t Count( const JsonTape* aTape,
+                             const size_t    aIndex,
+                             const RANGE&    aRange )
+        {
+            if ( aTape == nullptr ) {
+                return 0;
+            }
+
+            const size_t lCount = static_cast<size_t>( aTape->Payload( aIndex ) >> 32 );
+
+            if ( lCount < JsonTape::kCountMask ) {
+                return lCount;
+            }
+
+            size_t lResult = 0;
+
+            for ( auto lIt = aRange.begin(); lIt != aRange.end(); ++lIt ) {
+                ++lResult;
+            }
+
+            return lResult;
+        }
+
+    private:
+        const JsonTape* mTape  = nullptr;
+        size_t          mIndex = 0;
+    };
+
+    /*!
+     * Items of a tape array in document order.
+     */
+    class TapeArray final
+    {
+    public:
+        class Iterator final
+        {
+        public:
+            Iterator( const JsonTape* aTape,
+                      const size_t    aIndex )
+                : mTape( aTape )
+                , mIndex( aIndex )
+            {}
+
+            TapeValue operator *() const
+            {
+                return TapeValue( mTape, mIndex );
+            }
+
+            Iterator& operator ++()
+            {
+                mIndex = mTape->After( mIndex );
+                return *this;
+            }
+
+            bool operator !=( const Iterator& aOther ) const
+            {
+                return mIndex != aOther.mIndex;
+            }
+
+        private:
+            const JsonTape* mTape;
+            size_t          mIndex;
+        };
+
+        TapeArray() = default;
+
+        TapeArray( const JsonTape* aTape,
+                   const size_t    aIndex )
+            : mTape( aTape )
+            , mIndex( aIndex )
+        {}
+
+        Iterator begin() const
+        {
+            return mTape == nullptr
+                   ? Iterator( nullptr, 0 )
+                   : Iterator( mTape, mIndex + 1 );
+        }
+
+        Iterator end() const
+        {
+            return mTape == nullptr
+                   ? Iterator( nullptr, 0 )
+                   : Iterator( mTape, mTape->After( mIndex ) - 1 );
+        }
+
+        size_t size() const
+        {
+            return TapeObject::Count( mTape, mIndex, *this );
+        }
+
+    private:
+        const JsonTape* mTape  = nullptr;
+        size_t          mIndex = 0;
+    };
+
+    inline eTapeTag TapeValue::Tag() const
+    {
+        return mTape->Tag( mIndex );
+    }
+
+    template<typename T>
+    std::optional<T> TapeValue::GetValue() const
+    {
+        if ( !IsValid() ) {
+            return std::nullopt;
+        }
+
+        const eTapeTag lTag = Tag();
+
+        if constexpr ( std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t> ) {
+            if ( ( lTag != eTapeTag::UInt ) && ( lTag != eTapeTag::Int ) ) {
+                return std::nullopt;
+            }
+
+            const uint64_t lBits = mTape->Bits( mIndex );
+
+            if ( ( lTag == eTapeTag::UInt ) == std::is_same_v<T, uint64_t> ) {
+                return static_cast<T>( lBits );
+            }
+
+            // the other type holds it when the top bit is clear
+            if ( ( lBits >> 63 ) != 0 ) {
+                return std::nullopt;
+            }
+
+            return static_cast<T>( lBits );
+        }
+        else if constexpr ( std::is_same_v<T, double> ) {
+            if ( lTag != eTapeTag::Double ) {
+                return std::nullopt;
+            }
+
+            double         lValue = 0;
+            const uint64_t lBits  = mTape->Bits( mIndex );
+            std::memcpy( &lValue, &lBits, sizeof( lValue ) );
+            return lValue;
+        }
+        else if constexpr ( std::is_same_v<T, bool> ) {
+            if ( ( lTag != eTapeTag::True ) && ( lTag != eTapeTag::False ) ) {
+                return std::nullopt;
+            }
+
+            return lTag == eTapeTag::True;
+        }
+        else if constexpr ( std::is_same_v<T, std::string_view> || std::is_same_v<T, std::string> ) {
+            if ( lTag != eTapeTag::String ) {
+                return std::nullopt;
+            }
+
+            return T( mTape->Text( mIndex ) );
+        }
+        else if constexpr ( std::is_same_v<T, TapeObject> ) {
+            if ( lTag != eTapeTag::Object ) {
+                return std::nullopt;
+            }
+
+            return TapeObject( mTape, mIndex );
+        }
+        else if constexpr ( std::is_same_v<T, TapeArray> ) {
+            if ( lTag != eTapeTag::Array ) {
+                return std::nullopt;
+            }
+
+            return TapeArray( mTape, mIndex );
+        }
+        else if constexpr ( std::is_same_v<T, JsonElement> || std::is_same_v<T, std::vector<JsonVariant>> ) {
+            if ( lTag != ( std::is_same_v<T, JsonElement>
+                           ? eTapeTag::Object
+                           : eTapeTag::Array ) )
+            {
+                return std::nullopt;
+            }
+
+            return std::move( ToVariant().template GetValueRef<T>() );
+        }
+        else {
+            return std::nullopt;
+        }
+    }
+
+    inline TapeValue TapeValue::operator []( const std::string_view aKey ) const
+    {
+        if ( !IsObject() ) {
+            return {};
+        }
+
+        return TapeObject( mTape, mIndex ).Find( aKey );
+    }
+
+    inline TapeValue TapeValue::operator []( const size_t aIndex ) const
+    {
+        if ( !IsArray() ) {
+            return {};
+        }
+
+        size_t lPosition = 0;
+
+        for ( const TapeValue lItem : TapeArray( mTape, mIndex ) ) {
+            if ( lPosition++ == aIndex ) {
+                return lItem;
+            }
+        }
+
+        return {};
+    }
+
+    inline JsonVariant TapeValue::ToVariant() const
+    {
+        JsonVariant lResult;
+
+        if ( !IsValid() ) {
+            return lResult;
+        }
+
+        switch ( Tag() ) {
+            case eTapeTag::Object:
+            {
+                JsonElement lObject;
+
+                for ( const TapeMember lMember : TapeObject( mTape, mIndex ) ) {
+                    lObject[ JsonKey( lMember.Key ) ] = lMember.Value.ToVariant();
+                }
+
+                lResult = JsonVariant( std::move( lObject ) );
+                break;
+            }
+
+            case eTapeTag::Array:
+            {
+                std::vector<JsonVariant> lArray;
+
+                for ( const TapeValue lItem : TapeArray( mTape, mIndex ) ) {
+                    lArray.push_back( lItem.ToVariant() );
+                }
+
+                lResult = JsonVariant( std::move( lArray ) );
+                break;
+            }
+
+            case eTapeTag::String:
+                lResult = JsonVariant( std::string( mTape->Text( mIndex ) ) );
+                break;
+
+            case eTapeTag::UInt:
+                lResult = JsonVariant( GetValue<uint64_t>().value() );
+                break;
+
+            case eTapeTag::Int:
+                lResult = JsonVariant( GetValue<int64_t>().value() );
+                break;
+
+            case eTapeTag::Double:
+                lResult = JsonVariant( GetValue<double>().value() );
+                break;
+
+            default:
+                lResult = JsonVariant( Tag() == eTapeTag::True );
+                break;
+        }
+
+        return lResult;
+    }
+
+    /*!
+     * Writes the parser events onto a JsonTape.
+     */
+    class TapeParserNotifier final : public IParserViewNotifier
+    {
+    public:
+        explicit TapeParserNotifier( JsonTape& aTape )
+            : mTape( aTape )
+        {}
+
+        void OnParsingStarted() override
+        {
+            mTape.Clear();
+            mOpen.clear();
+        }
+
+        void OnObjectBegin( const size_t           aID,
+                            const size_t           aParentID,
+                            const std::string_view aName ) override
+        {
+            Open( eTapeTag::Object, aName );
+        }
+
+        void OnObjectFinished( const size_t aID ) override
+        {
+            Close( eTapeTag::ObjectEnd );
+        }
+
+        void OnItemBegin( const size_t aParentID ) override
+        {}
+
+        void OnItemName( const std::string_view aName,
+                         const size_t           aParentID ) override
+        {}
+
+        void OnItemValueBegin( const eValueType aType ) override
+        {}
+
+        void OnItemValue( const Value&           aValue,
+                          const size_t           aParentID,
+                          const std::string_view aName ) override
+        {
+            BeginItem( aName );
+
+            std::visit( [ this ] ( const auto aItem )
+                        {
+                            using ItemT = std::decay_t<decltype( aItem )>;
+
+                            if constexpr ( std::is_same_v<ItemT, std::string_view> ) {
+                                mTape.AppendString( aItem );
+                            }
+                            else if constexpr ( std::is_same_v<ItemT, bool> ) {
+                                mTape.Append( aItem
+                                              ? eTapeTag::True
+                                              : eTapeTag::False, 0 );
+                            }
+                            else {
+                                uint64_t lBits = 0;
+                                std::memcpy( &lBits, &aItem, sizeof( lBits ) );
+                                mTape.Append( std::is_same_v<ItemT, uint64_t>
+                                              ? eTapeTag::UInt
+                                              : std::is_same_v<ItemT, int64_t>
+                                              ? eTapeTag::Int
+                                              : eTapeTag::Double, 0 );
+                                mTape.AppendBits( lBits );
+                            }
+                        }, aValue );
+        }
+
+        void OnArrayBegin( const size_t           aID,
+                           const size_t           aParentID,
+                           const std::string_view aName ) override
+        {
+            Open( eTapeTag::Array, aName );
+        }
+
+        void OnNextItem() override
+        {}
+
+        void OnArrayFinished( const size_t aID ) override
+        {
+            Close( eTapeTag::ArrayEnd );
+        }
+
+        void OnParsingFinished() override
+        {}
+
+        void OnError( const std::string& aError ) override
+        {}
+
+    private:
+        struct Frame final
+        {
+            size_t Open  = 0;
+            size_t Count = 0;
+        };
+
+        /*!
+         * Counts the item in its container and writes its key when the
+         * container is an object.
+         */
+        void BeginItem( const std::string_view aName )
+        {
+            if ( mOpen.empty() ) {
+                return;
+            }
+
+            ++mOpen.back().Count;
+
+            if ( mTape.Tag( mOpen.back().Open ) == eTapeTag::Object ) {
+                mTape.AppendString( aName );
+            }
+        }
+
+        void Open( const eTapeTag         aTag,
+                   const std::string_view aName )
+        {
+            BeginItem( aName );
+            mOpen.push_back( { mTape.Append( aTag, 0 ), 0 } );
+        }
+
+        void Close( const eTapeTag aTag )
+        {
+            mTape.Close( mOpen.back().Open, aTag, mOpen.back().Count );
+            mOpen.pop_back();
+        }
+
+    private:
+        JsonTape&          mTape;
+        std::vector<Frame> mOpen;
+    };
+
+    inline bool JsonTape::Parse( const std::string_view aJsonDocument )
+    {
+        StructuralIndex lIndex;
+        lIndex.Build( aJsonDocument );
+        return Parse( aJsonDocument, lIndex );
+    }
+
+    inline bool JsonTape::Parse( const std::string_view aJsonDocument,
+                                 const StructuralIndex& aIndex )
+    {
+        TapeParserNotifier                   lNotifier( *this );
+        BasicJsonParser<TapeParserNotifier>& lParser = BasicJsonParser<TapeParserNotifier>::ForThread();
+
+        if ( !lParser.Parse( aJsonDocument, aIndex, lNotifier ) ) {
+            Clear();
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+#include "structuralindex.h"
+#include "numberparser.h"
+#include "jsonstring.h"
+#include "parser.h"
+
+namespace jsbjson
+{
+    /*!
+     * Checks that a document is well formed JSON in valid UTF-8 without
+     * producing any events or values. The bytes are checked for UTF-8 first,
+     * then the grammar is checked on the structural index, which also flags
+     * raw control characters inside strings while it is built. Escapes are
+     * only checked when the document holds a backslash. Numbers are checked
+     * the way the parser reads them, so a number out of the range of a double
+     * is rejected too. Like the parser it takes objects as documents only and
+     * rejects nesting deeper than its maximum depth, so a document that
+     * validates also parses.
+     */
+    class JsonValidator final
+    {
+    public:
+        static constexpr size_t kDefaultMaxDepth = BasicJsonParser<IParserNotifier>::kDefaultMaxDepth;
+
+        explicit JsonValidator( const size_t aMaxDepth = kDefaultMaxDepth )
+            : mMaxDepth( aMaxDepth )
+        {}
+
+        /*!
+         * On failure aErrorOffset is the offset of the first byte that cannot
+         * start or continue a valid document, the document size when it ends
+         * early and the opening quote of a string that is never closed.
+         */
+        bool Validate( const std::string_view aJsonDocument,
+                       size_t&                aErrorOffset )
+        {
+            const size_t lUtf8Error = text::FindInvalidUtf8( aJsonDocument );
+
+            mIndex.Build( aJsonDocument );
+            aErrorOffset = std::min( { lUtf8Error, mIndex.ControlInString(), CheckGrammar( aJsonDocument ) } );
+            return aErrorOffset == std::string_view::npos;
+        }
+
+        bool Validate( const std::string_view aJsonDocument )
+        {
+            size_t lErrorOffset = 0;
+            return Validate( aJsonDocument, lErrorOffset );
+        }
+
+        /*!
+         * Validator owned by the calling thread, its index keeps its capacity.
+         */
+        static JsonValidator& ForThread()
+        {
+            thread_local JsonValidator lValidator;
+            return lValidator;
+        }
+
+    private:
+        enum class eState
+        {
+            Value
+            , FirstItem
+            , FirstKey
+            , Key
+            , AfterValue
+        };
+
+        static bool IsNext( const StructuralCursor& aCursor,
+                            const char              aChar )
+        {
+            return !aCursor.AtEnd()
+                   && ( aCursor.Peek() == aChar )
+                   && aCursor.IsBlankUntil( aCursor.Offset() );
+        }
+
+        /*!
+         * Offset of the first byte at the cursor that is not whitespace.
+         */
+        static size_t ErrorAt( const StructuralCursor& aCursor )
+        {
+            const size_t lEnd = aCursor.AtEnd()
+                                ? aCursor.Document.size()
+                                : aCursor.Offset();
+
+            for ( size_t lOffset = aCursor.After; lOffset < lEnd; ++lOffset ) {
+                if ( !StructuralCursor::IsWhitespace( aCursor.Document[ lOffset ] ) ) {
+                    return lOffset;
+                }
+            }
+
+            return lEnd;
+        }
+
+        /*!
+         * Steps over the string starting at the cursor, returns npos or the
+         * offset of the error.
+         */
+        size_t CheckString( StructuralCursor& aCursor ) const
+        {
+            const size_t lBegin = aCursor.Offset();
+            aCursor.Advance();
+
+            if ( aCursor.AtEnd() ) {
+                return lBegin;
+            }
+
+            const size_t lEnd = aCursor.Offset();
+            aCursor.Advance();
+
+            if ( !mIndex.HasBackslash() ) {
+                return std::string_view::npos;
+            }
+
+            const size_t lError = text::FindInvalid( aCursor.Document.substr( lBegin + 1, lEnd - lBegin - 1 ) );
+
+            return lError == std::string_view::npos
+                   ? lError
+                   : lBegin + 1 + lError;
+        }
+
+        size_t CheckGrammar( const std::string_view aJsonDocument )
+        {
+            StructuralCursor lCursor { aJsonDocument, mIndex.Positions() };
+            eState           lState = eState::Value;
+
+            mContainers.clear();
+
+            if ( !IsNext( lCursor, '{' ) ) {
+                return ErrorAt( lCursor );
+            }
+
+            for ( ;; ) {
+                switch ( lState ) {
+                    case eState::FirstItem:
+                        if ( IsNext( lCursor, ']' ) ) {
+                            lCursor.Advance();
+                            mContainers.pop_back();
+                            lState = eState::AfterValue;
+                            break;
+                        }
+
+                        [[fallthrough]];
+
+                    case eState::Value:
+                    {
+                        const size_t lEnd = lCursor.AtEnd()
+                                            ? aJsonDocument.size()
+                                            : lCursor.Offset();
+
+                        if ( !lCursor.IsBlankUntil( lEnd ) ) {
+                            // a literal runs up to the next structural
+                            const std::string_view lLiteral = lCursor.Span( lCursor.After, lEnd );
+
+                            if ( ( lLiteral != "true" ) && ( lLiteral != "false" ) && !number::Parse( lLiteral ).has_value() ) {
+                                return static_cast<size_t>( lLiteral.data() - aJsonDocument.data() );
+                            }
+
+                            lCursor.After = lEnd;
+                            lState        = eState::AfterValue;
+                            break;
+                        }
+
+                        if ( lCursor.AtEnd() ) {
+                            return aJsonDocument.size();
+                        }
+
+                        const char lChar = lCursor.Peek();
+
+                        if ( ( lChar == '{' ) || ( lChar == '[' ) ) {
+                            if ( mContainers.size() >= mMaxDepth ) {
+                                return lCursor.Offset();
+                            }
+
+                            lCursor.Advance();
+                            mContainers.push_back( lChar == '{'
+                                                   ? '}'
+                                                   : ']' );
+                            lState = lChar == '{'
+                                     ? eState::FirstKey
+                                     : eState::FirstItem;
+                            break;
+                        }
+
+                        if ( lChar != '\"' ) {
+                            return lCursor.Offset();
+                        }
+
+                        const size_t lError = CheckString( lCursor );
+
+                        if ( lError != std::string_view::npos ) {
+                            return lError;
+                        }
+
+                        lState = eState::AfterValue;
+                        break;
+                    }
+
+                    case eState::FirstKey:
+                        if ( IsNext( lCursor, '}' ) ) {
+                            lCursor.Advance();
+                            mContainers.pop_back();
+                            lState = eState::AfterValue;
+                            break;
+                        }
+
+                        [[fallthrough]];
+
+                    case eState::Key:
+                    {
+                        if ( !IsNext( lCursor, '\"' ) ) {
+                            return ErrorAt( lCursor );
+                        }
+
+                        const size_t lError = CheckString( lCursor );
+
+                        if ( lError != std::string_view::npos ) {
+                            return lError;
+                        }
+
+                        if ( !IsNext( lCursor, ':' ) ) {
+                            return ErrorAt( lCursor );
+                        }
+
+                        lCursor.Advance();
+                        lState = eState::Value;
+                        break;
+                    }
+
+                    case eState::AfterValue:
+                        if ( mContainers.empty() ) {
+                            return lCursor.AtEnd() && lCursor.IsBlankUntil( aJsonDocument.size() )
+                                   ? std::string_view::npos
+                                   : ErrorAt( lCursor );
+                        }
+
+                        if ( IsNext( lCursor, mContainers.back() ) ) {
+                            lCursor.Advance();
+                            mContainers.pop_back();
+                            break;
+                        }
+
+                        if ( !IsNext( lCursor, ',' ) ) {
+                            return ErrorAt( lCursor );
+                        }
+
+                        lCursor.Advance();
+                        lState = mContainers.back() == '}'
+                                 ? eState::Key
+                                 : eState::Value;
+                        break;
+                }
+            }
+        }
+
+    private:
+        StructuralIndex   mIndex;
+        std::vector<char> mContainers;   /*!<closing bracket of each open container*/
+        size_t            mMaxDepth = kDefaultMaxDepth;
+    };
+}
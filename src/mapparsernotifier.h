@@ -6,12 +6,12 @@
 #include <iostream>
 #include <iomanip>
 #include <type_traits>
-#include <list>
-#include <map>
-#include <any>
+#include <vector>
 #include "iparsernotifier.h"
 #include "typehelpers.h"
 #include "jsonelement.h"
+#include "jsonkey.h"
+#include "dombuilder.h"
 
 namespace jsbjson
 {
@@ -20,62 +20,40 @@ namespace jsbjson
     public:
         MapParserNotifier( JsonElement& aResult )
             : mRoot( aResult )
+            , mBuilder( mDocumentKeys )
+        {}
+
+        /*!
+         * Interns the keys into aKeys, which may be shared by many documents
+         * so their keys are stored once.
+         */
+        MapParserNotifier( JsonElement& aResult,
+                           KeyTable&    aKeys )
+            : mRoot( aResult )
+            , mBuilder( aKeys )
         {}
 
     public:
         void OnParsingStarted()
         {
-            mObjects.clear();
-            mArrays.clear();
-            mParents.clear();
-            mArrayNames.clear();
-            mObjectNames.clear();
+            mBuilder.Start();
         }
 
         void OnParsingFinished()
         {
-            if ( mObjects.size() != 1 ) {
-                return;
-            }
-
-            mRoot = mObjects.begin()->second;
-            mObjects.clear();
-            mArrays.clear();
-            mParents.clear();
-            mArrayNames.clear();
-            mObjectNames.clear();
+            mBuilder.Finish( mRoot );
         }
 
         void OnObjectBegin( const size_t       aID,
                             const size_t       aParentID,
                             const std::string& aName )
         {
-            if ( mObjects.find( aParentID ) != mObjects.cend() ) {
-                mObjectNames[ aID ] = aName;
-            }
-
-            mParents[ aID ] = aParentID;
-            mObjects[ aID ] = JsonElement {};
+            mBuilder.Open( JsonElement {}, aName );
         }
 
         void OnObjectFinished( const size_t aID )
         {
-            const ID_t  lParent      = mParents[ aID ];
-            const auto& lParentArray = mArrays.find( lParent );
-
-            if ( lParentArray != mArrays.cend() ) {
-                lParentArray->second.push_back( mObjects[ aID ] );
-                mObjects.erase( aID );
-                return;
-            }
-
-            const std::string& lObjectName   = mObjectNames[ aID ];
-            const auto&        lParentObject = mObjects.find( lParent );
-
-            if ( lParentObject != mObjects.cend() ) {
-                lParentObject->second[ lObjectName ] = mObjects[ aID ];
-                mObjects.erase( aID );
-            }
+            mBuilder.Close();
         }
 
         void OnItemBegin( const size_t aParentID )
@@ -95,32 +73,21 @@ namespace jsbjson
                           const size_t                                                     aParentID,
                           const std::string&                                               aName )
         {
-            if ( mObjects.find( aParentID ) != mObjects.cend() ) {
-                std::visit( [ &, this ] (const auto& aItem)
-                            {
-                                mObjects[ aParentID ][ aName ] = aItem;
-                            }, aValue );
+            if ( !mBuilder.IsOpen() ) {
+                return;
             }
 
-            if ( mArrays.find( aParentID ) != mArrays.end() ) {
-                std::visit( [ &, this ] (const auto& aItem)
-                            {
-                                mArrays[ aParentID ].push_back( aItem );
-                            }, aValue );
-            }
+            std::visit( [ &, this ] (const auto& aItem)
+                        {
+                            mBuilder.AddValue( aName, JsonVariant( aItem ) );
+                        }, aValue );
         }
 
         virtual void OnArrayBegin( const size_t       aID,
                                    const size_t       aParentID,
                                    const std::string& aName )
         {
-            mArrays[ aID ] = std::vector<JsonVariant> {};
-
-            if ( !aName.empty() ) {
-                mArrayNames[ aID ] = aName;
-            }
-
-            mParents[ aID ] = aParentID;
+            mBuilder.Open( std::vector<JsonVariant> {}, aName );
         }
 
         virtual void OnNextItem()
@@ -129,30 +96,7 @@ namespace jsbjson
 
         virtual void OnArrayFinished( const size_t aID )
         {
-            const ID_t  lParent       = mParents[ aID ];
-            const auto& lParentObject = mObjects.find( lParent );
-
-            const auto& lArrayItem = mArrays[ aID ];
-
-            if ( lParentObject != mObjects.cend() ) {
-                const std::string& lArrayName = mArrayNames[ aID ];
-
-                lParentObject->second[ lArrayName ] = lArrayItem;
-
-                mArrays.erase( aID );
-                return;
-            }
-
-            const auto& lParentArray = mArrays.find( lParent );
-
-            if ( lParentArray == mArrays.cend() ) {
-                // Should not happen
-                return;
-            }
-
-            lParentArray->second.push_back( lArrayItem );
-
-            mArrays.erase( aID );
+            mBuilder.Close();
         }
 
         virtual void OnError( const std::string& aErrorMessage )
@@ -161,13 +105,7 @@ namespace jsbjson
 
     private:
         JsonElement& mRoot;
-        using ID_t = size_t;
-        std::map<ID_t, JsonElement>              mObjects;
-        std::map<ID_t, std::vector<JsonVariant>> mArrays;
-        std::map<ID_t, ID_t>                     mParents;                                                                                 /*!<first: the child id, second: the parent id*/
-        std::map<ID_t, std::string>              mArrayNames;
-        std::map<ID_t, std::string>              mObjectNames;
-
-    private:
+        KeyTable     mDocumentKeys;
+        DomBuilder   mBuilder;
     };
 }
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#if defined( _WIN32 )
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jsbjson
+{
+    /*!
+     * Read-only memory mapping of a whole file. The mapping is advised for
+     * sequential access and released when the object goes out of scope.
+     */
+    class MappedFile final
+    {
+    public:
+        explicit MappedFile( const std::string& aPath )
+        {
+            Open( aPath );
+        }
+
+        ~MappedFile()
+        {
+            Close();
+        }
+
+        MappedFile( const MappedFile& )            = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+
+        bool IsOpen() const
+        {
+            return mIsOpen;
+        }
+
+        std::string_view View() const
+        {
+            return std::string_view( mData, mSize );
+        }
+
+    private:
+#if defined( _WIN32 )
+        void Open( const std::string& aPath )
+        {
+            const HANDLE lFile = CreateFileA( aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+
+            if ( lFile == INVALID_HANDLE_VALUE ) {
+                return;
+            }
+
+            LARGE_INTEGER lSize {};
+
+            if ( !GetFileSizeEx( lFile, &lSize ) ) {
+                CloseHandle( lFile );
+                return;
+            }
+
+            if ( lSize.QuadPart == 0 ) {
+                CloseHandle( lFile );
+                mIsOpen = true;
+                return;
+            }
+
+            const HANDLE lMapping = CreateFileMappingA( lFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            CloseHandle( lFile );
+
+            if ( lMapping == nullptr ) {
+                return;
+            }
+
+            const void* lView = MapViewOfFile( lMapping, FILE_MAP_READ, 0, 0, 0 );
+            CloseHandle( lMapping );
+
+            if ( lView == nullptr ) {
+                return;
+            }
+
+            mData   = static_cast<const char*>( lView );
+            mSize   = static_cast<size_t>( lSize.QuadPart );
+            mIsOpen = true;
+        }
+
+        void Close()
+        {
+            if ( mData != nullptr ) {
+                UnmapViewOfFile( mData );
+            }
+        }
+
+#else
+        void Open( const std::string& aPath )
+        {
+            const int lFile = open( aPath.c_str(), O_RDONLY );
+
+            if ( lFile < 0 ) {
+                return;
+            }
+
+            struct stat lStat {};
+
+            if ( fstat( lFile, &lStat ) != 0 ) {
+                close( lFile );
+                return;
+            }
+
+            if ( lStat.st_size == 0 ) {
+                close( lFile );
+                mIsOpen = true;
+                return;
+            }
+
+            void* lView = mmap( nullptr, static_cast<size_t>( lStat.st_size ), PROT_READ, MAP_PRIVATE, lFile, 0 );
+            close( lFile );
+
+            if ( lView == MAP_FAILED ) {
+                return;
+            }
+
+            madvise( lView, static_cast<size_t>( lStat.st_size ), MADV_SEQUENTIAL );
+
+            mData   = static_cast<const char*>( lView );
+            mSize   = static_cast<size_t>( lStat.st_size );
+            mIsOpen = true;
+        }
+
+        void Close()
+        {
+            if ( mData != nullptr ) {
+                munmap( const_cast<char*>( mData ), mSize );
+            }
+        }
+#endif
+
+    private:
+        const char* mData   = nullptr;
+        size_t      mSize   = 0;
+        bool        mIsOpen = false;
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include "iparserviewnotifier.h"
+#include "jsonelement.h"
+#include "jsonkey.h"
+#include "dombuilder.h"
+
+namespace jsbjson
+{
+    /*!
+     * Builds a JsonElement like MapParserNotifier, but string values that
+     * needed no unescaping are borrowed from aDocument instead of copied, see
+     * JsonVariant::Borrowed(). aDocument must outlive the element.
+     */
+    class MapViewParserNotifier final : public IParserViewNotifier
+    {
+    public:
+        MapViewParserNotifier( JsonElement&           aResult,
+                               const std::string_view aDocument )
+            : mRoot( aResult )
+            , mDocument( aDocument )
+            , mBuilder( mDocumentKeys )
+        {}
+
+        MapViewParserNotifier( JsonElement&           aResult,
+                               const std::string_view aDocument,
+                               KeyTable&              aKeys )
+            : mRoot( aResult )
+            , mDocument( aDocument )
+            , mBuilder( aKeys )
+        {}
+
+        void OnParsingStarted() override
+        {
+            mBuilder.Start();
+        }
+
+        void OnParsingFinished() override
+        {
+            mBuilder.Finish( mRoot );
+        }
+
+        void OnObjectBegin( const size_t           aID,
+                            const size_t           aParentID,
+                            const std::string_view aName ) override
+        {
+            mBuilder.Open( JsonElement {}, aName );
+        }
+
+        void OnObjectFinished( const size_t aID ) override
+        {
+            mBuilder.Close();
+        }
+
+        void OnItemBegin( const size_t aParentID ) override
+        {}
+
+        void OnItemName( const std::string_view aName,
+                         const size_t           aParentID ) override
+        {}
+
+        void OnItemValueBegin( const eValueType aType ) override
+        {}
+
+        void OnItemValue( const Value&           aValue,
+                          const size_t           aParentID,
+                          const std::string_view aName ) override
+        {
+            if ( !mBuilder.IsOpen() ) {
+                return;
+            }
+
+            std::visit( [ &, this ] ( const auto& aItem )
+                        {
+                            if constexpr ( std::is_same_v<std::decay_t<decltype( aItem )>, std::string_view> ) {
+                                mBuilder.AddValue( aName, IsInDocument( aItem )
+                                                          ? JsonVariant::Borrowed( aItem )
+                                                          : JsonVariant( std::string( aItem ) ) );
+                            }
+                            else {
+                                mBuilder.AddValue( aName, JsonVariant( aItem ) );
+                            }
+                        }, aValue );
+        }
+
+        void OnArrayBegin( const size_t           aID,
+                           const size_t           aParentID,
+                           const std::string_view aName ) override
+        {
+            mBuilder.Open( std::vector<JsonVariant> {}, aName );
+        }
+
+        void OnNextItem() override
+        {}
+
+        void OnArrayFinished( const size_t aID ) override
+        {
+            mBuilder.Close();
+        }
+
+        void OnError( const std::string& aError ) override
+        {}
+
+    private:
+        /*!
+         * Escaped text is decoded into a parser buffer, only views into the
+         * document itself can be kept.
+         */
+        bool IsInDocument( const std::string_view aText ) const
+        {
+            return !std::less<const char*> {}( aText.data(), mDocument.data() )
+                   && !std::less<const char*> {}( mDocument.data() + mDocument.size(), aText.data() + aText.size() );
+        }
+
+    private:
+        JsonElement&     mRoot;
+        std::string_view mDocument;
+        KeyTable         mDocumentKeys;
+        DomBuilder       mBuilder;
+    };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace jsbjson
+{
+    /*!
+     * Contiguous stack for the parser nesting. The first INLINE_CAPACITY frames
+     * live inside the object, deeper frames spill into a vector that keeps its
+     * capacity across Clear() calls.
+     */
+    template<typename FRAME, size_t INLINE_CAPACITY>
+    class NestingStack final
+    {
+    public:
+        bool Empty() const
+        {
+            return mSize == 0;
+        }
+
+        size_t Size() const
+        {
+            return mSize;
+        }
+
+        void Push( const FRAME& aFrame )
+        {
+            if ( mSize < INLINE_CAPACITY ) {
+                mInline[ mSize ] = aFrame;
+            }
+            else {
+                mSpill.push_back( aFrame );
+            }
+
+            ++mSize;
+        }
+
+        void Pop()
+        {
+            if ( mSize > INLINE_CAPACITY ) {
+                mSpill.pop_back();
+            }
+
+            --mSize;
+        }
+
+        const FRAME& Back() const
+        {
+            return mSize > INLINE_CAPACITY
+                   ? mSpill.back()
+                   : mInline[ mSize - 1 ];
+        }
+
+        void Clear()
+        {
+            mSpill.clear();
+            mSize = 0;
+        }
+
+    private:
+        std::array<FRAME, INLINE_CAPACITY> mInline {};
+        std::vector<FRAME>                 mSpill;
+        size_t                             mSize = 0;
+    };
+}
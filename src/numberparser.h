@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <variant>
+#include "powersoffive.h"
+
+#if defined( _MSC_VER ) && defined( _M_X64 )
+#include <intrin.h>
+#endif
+
+namespace jsbjson
+{
+    namespace number
+    {
+        using Value = std::variant<uint64_t, int64_t, double>;
+
+        struct UInt128 final
+        {
+            uint64_t High = 0;
+            uint64_t Low  = 0;
+        };
+
+        inline UInt128 Multiply( const uint64_t aLeft,
+                                 const uint64_t aRight )
+        {
+#if defined( __SIZEOF_INT128__ )
+            const unsigned __int128 lProduct = static_cast<unsigned __int128>( aLeft ) * aRight;
+            return { static_cast<uint64_t>( lProduct >> 64 ), static_cast<uint64_t>( lProduct ) };
+#elif defined( _MSC_VER ) && defined( _M_X64 )
+            UInt128 lProduct;
+            lProduct.Low = _umul128( aLeft, aRight, &lProduct.High );
+            return lProduct;
+#else
+            const uint64_t lLeftLow   = aLeft & 0xFFFFFFFFULL;
+            const uint64_t lLeftHigh  = aLeft >> 32;
+            const uint64_t lRightLow  = aRight & 0xFFFFFFFFULL;
+            const uint64_t lRightHigh = aRight >> 32;
+            const uint64_t lLowLow    = lLeftLow * lRightLow;
+            const uint64_t lHighLow   = lLeftHigh * lRightLow;
+            const uint64_t lLowHigh   = lLeftLow * lRightHigh;
+            const uint64_t lCross     = ( lLowLow >> 32 ) + ( lHighLow & 0xFFFFFFFFULL ) + lLowHigh;
+            return { lLeftHigh * lRightHigh + ( lHighLow >> 32 ) + ( lCross >> 32 ), ( lCross << 32 ) | ( lLowLow & 0xFFFFFFFFULL ) };
+#endif
+        }
+
+        inline int CountLeadingZeros( const uint64_t aValue )
+        {
+#if defined( _MSC_VER )
+            unsigned long lIndex = 0;
+            _BitScanReverse64( &lIndex, aValue );
+            return 63 - static_cast<int>( lIndex );
+#else
+            return __builtin_clzll( aValue );
+#endif
+        }
+
+        inline double FromBits( const uint64_t aBits )
+        {
+            double lResult = 0;
+            std::memcpy( &lResult, &aBits, sizeof( lResult ) );
+            return lResult;
+        }
+
+        /*!
+         * Eisel-Lemire: rounds aMantissa * 10^aExponent to the nearest double using
+         * one or two 64x64 bit products with a truncated power of five. Correct
+         * for every mantissa below 10^19, so no slow path is needed.
+         */
+        inline double ComputeFloat( uint64_t  aMantissa,
+                                    const int aExponent )
+        {
+            constexpr int      kMantissaBits = 52;
+            constexpr int      kInfinite     = 0x7FF;
+            constexpr uint64_t kPrecision    = 0xFFFFFFFFFFFFFFFFULL >> ( kMantissaBits + 3 );
+
+            if ( ( aMantissa == 0 ) || ( aExponent < kSmallestPowerOfTen ) ) {
+                return 0;
+            }
+
+            if ( aExponent > kLargestPowerOfTen ) {
+                return std::numeric_limits<double>::infinity();
+            }
+
+            const int lLeadingZeros = CountLeadingZeros( aMantissa );
+            aMantissa <<= lLeadingZeros;
+
+            const uint64_t* lPower   = kPowersOfFive[ aExponent - kSmallestPowerOfTen ];
+            UInt128         lProduct = Multiply( aMantissa, lPower[ 0 ] );
+
+            // only when the bits below the rounding position are all ones can the low word matter
+            if ( ( lProduct.High & kPrecision ) == kPrecision ) {
+                const UInt128 lSecond = Multiply( aMantissa, lPower[ 1 ] );
+                lProduct.Low += lSecond.High;
+
+                if ( lSecond.High > lProduct.Low ) {
+                    ++lProduct.High;
+                }
+            }
+
+            const int lUpperBit = static_cast<int>( lProduct.High >> 63 );
+            const int lShift    = lUpperBit + 64 - kMantissaBits - 3;
+            uint64_t  lBits     = lProduct.High >> lShift;
+            int       lPower2   = ( ( ( 152170 + 65536 ) * aExponent ) >> 16 ) + 63 + lUpperBit - lLeadingZeros + 1023;
+
+            if ( lPower2 <= 0 ) {
+                if ( -lPower2 + 1 >= 64 ) {
+                    return 0;
+                }
+
+                lBits >>= -lPower2 + 1;
+                lBits += lBits & 1;
+                lBits >>= 1;
+                lPower2 = lBits < ( uint64_t { 1 } << kMantissaBits )
+                          ? 0
+                          : 1;
+                return FromBits( ( lBits & ~( uint64_t { 1 } << kMantissaBits ) ) | ( static_cast<uint64_t>( lPower2 ) << kMantissaBits ) );
+            }
+
+            // exactly halfway between two doubles: round to even instead of up
+            if ( ( lProduct.Low <= 1 )
+                 && ( aExponent >= -4 )
+                 && ( aExponent <= 23 )
+                 && ( ( lBits & 3 ) == 1 )
+                 && ( ( lBits << lShift ) == lProduct.High ) )
+            {
+                lBits &= ~uint64_t { 1 };
+            }
+
+            lBits += lBits & 1;
+            lBits >>= 1;
+
+            if ( lBits >= ( uint64_t { 2 } << kMantissaBits ) ) {
+                lBits = uint64_t { 1 } << kMantissaBits;
+                ++lPower2;
+            }
+
+            if ( lPower2 >= kInfinite ) {
+                return std::numeric_limits<double>::infinity();
+            }
+
+            lBits &= ~( uint64_t { 1 } << kMantissaBits );
+            return FromBits( lBits | ( static_cast<uint64_t>( lPower2 ) << kMantissaBits ) );
+        }
+
+        inline double ToDouble( const uint64_t aMantissa,
+                                const int      aExponent )
+        {
+            constexpr double kPowersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+            // both operands are exact doubles, so a single rounding gives the correct result
+            if ( ( aMantissa <= ( uint64_t { 1 } << 53 ) ) && ( aExponent >= -22 ) && ( aExponent <= 22 ) ) {
+                const double lMantissa = static_cast<double>( aMantissa );
+
+                return aExponent < 0
+                       ? lMantissa / kPowersOfTen[ -aExponent ]
+                       : lMantissa * kPowersOfTen[ aExponent ];
+            }
+
+            return ComputeFloat( aMantissa, aExponent );
+        }
+
+        inline const char* ScanDigits( const char* aCursor,
+                                       const char* aEnd,
+                                       uint64_t&   aValue )
+        {
+            while ( ( aCursor != aEnd ) && ( static_cast<unsigned char>( *aCursor - '0' ) <= 9 ) ) {
+                aValue = aValue * 10 + static_cast<uint64_t>( *aCursor - '0' );
+                ++aCursor;
+            }
+
+            return aCursor;
+        }
+
+        /*!
+         * Parses a JSON number in one pass. Integers come out as uint64_t, or as
+         * int64_t when negative, and everything else (fractions, exponents and
+         * integers out of range) as double. Returns nothing for malformed text and
+         * for values a double cannot hold.
+         */
+        inline std::optional<Value> Parse( const std::string_view aText )
+        {
+            const char* lCursor   = aText.data();
+            const char* lEnd      = lCursor + aText.size();
+            const bool  lNegative = ( lCursor != lEnd ) && ( *lCursor == '-' );
+
+            if ( lNegative ) {
+                ++lCursor;
+            }
+
+            // the digits are accumulated while scanning, a wrapped value is only used after counting them
+            uint64_t          lMantissa      = 0;
+            const char* const lIntegerBegin  = lCursor;
+            lCursor                          = ScanDigits( lCursor, lEnd, lMantissa );
+            const size_t      lIntegerDigits = static_cast<size_t>( lCursor - lIntegerBegin );
+
+            if ( ( lIntegerDigits == 0 ) || ( ( *lIntegerBegin == '0' ) && ( lIntegerDigits > 1 ) ) ) {
+                return std::nullopt;
+            }
+
+            size_t  lFractionDigits = 0;
+            int64_t lExponent       = 0;
+            bool    lIsInteger      = true;
+
+            if ( ( lCursor != lEnd ) && ( *lCursor == '.' ) ) {
+                const char* const lFractionBegin = ++lCursor;
+                lCursor         = ScanDigits( lCursor, lEnd, lMantissa );
+                lFractionDigits = static_cast<size_t>( lCursor - lFractionBegin );
+
+                if ( lFractionDigits == 0 ) {
+                    return std::nullopt;
+                }
+
+                lExponent  = -static_cast<int64_t>( lFractionDigits );
+                lIsInteger = false;
+            }
+
+            if ( ( lCursor != lEnd ) && ( ( *lCursor == 'e' ) || ( *lCursor == 'E' ) ) ) {
+                ++lCursor;
+                const bool lNegativeExponent = ( lCursor != lEnd ) && ( *lCursor == '-' );
+
+                if ( ( lCursor != lEnd ) && ( ( *lCursor == '-' ) || ( *lCursor == '+' ) ) ) {
+                    ++lCursor;
+                }
+
+                const char* const lExponentBegin = lCursor;
+                int64_t           lValue         = 0;
+
+                for ( ; ( lCursor != lEnd ) && ( static_cast<unsigned char>( *lCursor - '0' ) <= 9 ); ++lCursor ) {
+                    // saturate, anything this large is out of range anyway
+                    if ( lValue < 100000000 ) {
+                        lValue = lValue * 10 + ( *lCursor - '0' );
+                    }
+                }
+
+                if ( lCursor == lExponentBegin ) {
+                    return std::nullopt;
+                }
+
+                lExponent += lNegativeExponent
+                             ? -lValue
+                             : lValue;
+                lIsInteger = false;
+            }
+
+            if ( lCursor != lEnd ) {
+                return std::nullopt;
+            }
+
+            const size_t lDigits = lIntegerDigits + lFractionDigits;
+
+            if ( lIsInteger ) {
+                constexpr uint64_t kMinInt64Magnitude = uint64_t { 1 } << 63;
+
+                if ( lDigits <= 19 ) {
+                    if ( !lNegative ) {
+                        return Value( std::in_place_type<uint64_t>, lMantissa );
+                    }
+
+                    if ( lMantissa <= kMinInt64Magnitude ) {
+                        return Value( std::in_place_type<int64_t>, static_cast<int64_t>( 0 - lMantissa ) );
+                    }
+                }
+                else if ( !lNegative && ( lDigits == 20 ) ) {
+                    uint64_t lValue = 0;
+                    const auto [ lPtr, lErrorCode ] = std::from_chars( lIntegerBegin, lEnd, lValue );
+
+                    if ( lErrorCode == std::errc() ) {
+                        return Value( std::in_place_type<uint64_t>, lValue );
+                    }
+                }
+            }
+
+            // leading zeros of "0.000ddd" do not count against the 19 digits the fast path can take
+            size_t lSignificantDigits = lDigits;
+
+            if ( ( lDigits > 19 ) && ( *lIntegerBegin == '0' ) ) {
+                for ( const char* lDigit = lIntegerBegin; ( lDigit != lEnd ) && ( ( *lDigit == '0' ) || ( *lDigit == '.' ) ); ++lDigit ) {
+                    if ( *lDigit == '0' ) {
+                        --lSignificantDigits;
+                    }
+                }
+            }
+
+            double lResult = 0;
+
+            if ( lSignificantDigits <= 19 ) {
+                lResult = ToDouble( lMantissa, static_cast<int>( std::clamp<int64_t>( lExponent, -100000, 100000 ) ) );
+
+                if ( ( lResult == std::numeric_limits<double>::infinity() ) || ( ( lResult == 0 ) && ( lMantissa != 0 ) ) ) {
+                    return std::nullopt;
+                }
+            }
+            else {
+                const auto [ lPtr, lErrorCode ] = std::from_chars( aText.data(), lEnd, lResult );
+
+                if ( ( lPtr != lEnd ) || ( lErrorCode != std::errc() ) ) {
+                    return std::nullopt;
+                }
+
+                return Value( std::in_place_type<double>, lResult );
+            }
+
+            return Value( std::in_place_type<double>, lNegative
+                                                      ? -lResult
+                                                      : lResult );
+        }
+    }
+}
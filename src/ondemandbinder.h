@@ -0,0 +1,500 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "structuralindex.h"
+#include "numberparser.h"
+#include "jsonstring.h"
+#include "typehelpers.h"
+#include "jsonelement.h"
+#include "parser.h"
+#include "mapparsernotifier.h"
+
+namespace jsbjson
+{
+    /*!
+     * Binds a document straight into OBJECT by walking the structural index,
+     * without building a JsonElement first. Keys OBJECT does not declare are
+     * skipped together with their whole value by counting brackets, so unknown
+     * subtrees cost no allocation. Skipped values are only checked for balanced
+     * brackets, bound values are parsed and checked in full. Binding follows the
+     * same rules as ToObject, including the last of duplicate keys winning.
+     */
+    template<typename OBJECT>
+    class OnDemandBinder final
+    {
+    public:
+        std::optional<std::decay_t<OBJECT>> operator ()( const std::string_view aJsonDocument )
+        {
+            StructuralIndex lIndex;
+
+            if ( !lIndex.Build( aJsonDocument ) ) {
+                return std::nullopt;
+            }
+
+            return ( *this )( aJsonDocument, lIndex );
+        }
+
+        std::optional<std::decay_t<OBJECT>> operator ()( const std::string_view aJsonDocument,
+                                                         const StructuralIndex& aIndex )
+        {
+            if constexpr ( !IsObject<OBJECT>::value ) {
+                return std::nullopt;
+            }
+            else {
+                StructuralCursor lCursor { aJsonDocument, aIndex.Positions() };
+
+                if ( !aIndex.IsFor( aJsonDocument ) || !aIndex.IsComplete() || !IsContainerStart( lCursor, '{' ) ) {
+                    return std::nullopt;
+                }
+
+                std::decay_t<OBJECT> lObject;
+
+                if ( !BindObject( lCursor, lObject )
+                     || !lCursor.AtEnd()
+                     || !lCursor.IsBlankUntil( aJsonDocument.size() ) )
+                {
+                    return std::nullopt;
+                }
+
+                return lObject;
+            }
+        }
+
+    private:
+        enum class eValue
+        {
+            Scalar
+            , Container
+            , Invalid
+        };
+
+        static bool IsContainerStart( const StructuralCursor& aCursor,
+                                      const char              aBracket )
+        {
+            return !aCursor.AtEnd()
+                   && ( aCursor.Peek() == aBracket )
+                   && aCursor.IsBlankUntil( aCursor.Offset() );
+        }
+
+        /*!
+         * Consumes the ',' between items and returns true, or the closing bracket
+         * and sets aClosed. Anything else is an error.
+         */
+        static bool NextItem( StructuralCursor& aCursor,
+                              const char        aClosing,
+                              bool&             aClosed,
+                              bool&             aSuccess )
+        {
+            if ( aCursor.AtEnd() || !aCursor.IsBlankUntil( aCursor.Offset() ) ) {
+                aSuccess = false;
+                return false;
+            }
+
+            const char lChar = aCursor.Peek();
+            aCursor.Advance();
+            aClosed  = lChar == aClosing;
+            aSuccess = aClosed || ( lChar == ',' );
+            return aSuccess && !aClosed;
+        }
+
+        template<typename TARGET>
+        static const std::vector<std::string>& MemberNames()
+        {
+            static const std::vector<std::string> kNames = [] ()
+                                                           {
+                                                               TARGET                   lTarget;
+                                                               std::vector<std::string> lNames;
+
+                                                               std::apply( [ & ] (auto&... aArgs)
+                                                                           {
+                                                                               ( lNames.push_back( aArgs.Name() ), ... );
+                                                                           }, lTarget.ConvertRef() );
+                                                               return lNames;
+                                                           } ();
+
+            return kNames;
+        }
+
+        template<typename TARGET>
+        bool BindObject( StructuralCursor& aCursor,
+                         TARGET&           aTarget )
+        {
+            aCursor.Advance();
+
+            if ( IsContainerStart( aCursor, '}' ) ) {
+                aCursor.Advance();
+                return true;
+            }
+
+            const std::vector<std::string>& lNames = MemberNames<TARGET>();
+            std::string                     lDecodedKey;
+            bool                            lClosed  = false;
+            bool                            lSuccess = true;
+
+            do {
+                if ( !IsContainerStart( aCursor, '\"' ) ) {
+                    return false;
+                }
+
+                const size_t lBegin = aCursor.Offset();
+                aCursor.Advance();
+
+                if ( aCursor.AtEnd() ) {
+                    return false;
+                }
+
+                std::string_view lKey = aCursor.Document.substr( lBegin + 1, aCursor.Offset() - lBegin - 1 );
+                aCursor.Advance();
+
+                // keys are compared decoded, only keys with escapes need a copy
+                if ( lKey.find( '\\' ) != std::string_view::npos ) {
+                    lDecodedKey.assign( lKey.data(), lKey.size() );
+
+                    if ( !text::Unescape( lDecodedKey ) ) {
+                        return false;
+                    }
+
+                    lKey = lDecodedKey;
+                }
+
+                if ( !IsContainerStart( aCursor, ':' ) ) {
+                    return false;
+                }
+
+                aCursor.Advance();
+
+                if ( !BindMember( aCursor, aTarget, lNames, lKey ) ) {
+                    return false;
+                }
+            } while ( NextItem( aCursor, '}', lClosed, lSuccess ) );
+
+            return lSuccess;
+        }
+
+        template<typename TARGET>
+        bool BindMember( StructuralCursor&               aCursor,
+                         TARGET&                         aTarget,
+                         const std::vector<std::string>& aNames,
+                         const std::string_view          aKey )
+        {
+            const size_t lIndex   = aCursor.Index;
+            const size_t lAfter   = aCursor.After;
+            bool         lMatched = false;
+            bool         lSuccess = true;
+            size_t       lMember  = 0;
+
+            std::apply( [ & ] (auto&... aArgs)
+                        {
+                            ( ( lSuccess = BindIfNamed( aCursor, aArgs, aNames[ lMember++ ] == aKey, lIndex, lAfter, lMatched ) && lSuccess ), ... );
+                        }, aTarget.ConvertRef() );
+
+            if ( !lMatched ) {
+                return SkipValue( aCursor );
+            }
+
+            return lSuccess;
+        }
+
+        template<typename MEMBER>
+        bool BindIfNamed( StructuralCursor& aCursor,
+                          MEMBER&           aMember,
+                          const bool        aNamed,
+                          const size_t      aIndex,
+                          const size_t      aAfter,
+                          bool&             aMatched )
+        {
+            if ( !aNamed ) {
+                return true;
+            }
+
+            // every member with this name binds from the same value
+            aCursor.Index = aIndex;
+            aCursor.After = aAfter;
+            aMatched      = true;
+            return BindValue( aCursor, aMember );
+        }
+
+        template<typename MEMBER>
+        bool BindValue( StructuralCursor& aCursor,
+                        MEMBER&           aMember )
+        {
+            if constexpr ( IsObject<MEMBER>::value ) {
+                aMember = MEMBER {};
+
+                if ( !IsContainerStart( aCursor, '{' ) ) {
+                    return SkipValue( aCursor );
+                }
+
+                return BindObject( aCursor, aMember );
+            }
+            else if constexpr ( IsMember<MEMBER>::value ) {
+                using MemberT = typename MEMBER::Type;
+
+                aMember = MEMBER {};
+
+                if constexpr ( IsArray<MemberT>::value ) {
+                    if ( !IsContainerStart( aCursor, '[' ) ) {
+                        return SkipValue( aCursor );
+                    }
+
+                    MemberT lResult;
+
+                    if ( !BindArray( aCursor, lResult ) ) {
+                        return false;
+                    }
+
+                    aMember.Value = std::move( lResult );
+                    aMember.IsSet = true;
+                    return true;
+                }
+                else if constexpr ( std::is_same_v<MemberT, JsonElement> ) {
+                    return BindElement( aCursor, aMember );
+                }
+                else {
+                    JsonVariant  lValue;
+                    const eValue lKind = ReadScalar( aCursor, lValue );
+
+                    if ( lKind == eValue::Container ) {
+                        return SkipValue( aCursor );
+                    }
+
+                    if ( lKind == eValue::Invalid ) {
+                        return false;
+                    }
+
+                    std::optional<MemberT> lResult = lValue.GetValue<MemberT>();
+
+                    if ( lResult.has_value() ) {
+                        aMember.Value = std::move( lResult.value() );
+                        aMember.IsSet = true;
+                    }
+
+                    return true;
+                }
+            }
+            else {
+                return SkipValue( aCursor );
+            }
+        }
+
+        template<typename ARRAY>
+        bool BindArray( StructuralCursor& aCursor,
+                        ARRAY&            aResult )
+        {
+            using ItemT = typename ARRAY::value_type;
+
+            aCursor.Advance();
+
+            if ( IsContainerStart( aCursor, ']' ) ) {
+                aCursor.Advance();
+                return true;
+            }
+
+            bool lClosed  = false;
+            bool lSuccess = true;
+
+            do {
+                if ( IsContainerStart( aCursor, '[' ) ) {
+                    if constexpr ( IsArray<ItemT>::value ) {
+                        ItemT lItem;
+
+                        if ( !BindArray( aCursor, lItem ) ) {
+                            return false;
+                        }
+
+                        aResult.push_back( std::move( lItem ) );
+                    }
+                    else if ( !SkipValue( aCursor ) ) {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                if ( IsContainerStart( aCursor, '{' ) ) {
+                    if constexpr ( HasConvertRef<ItemT>::value ) {
+                        ItemT lItem;
+
+                        if ( !BindObject( aCursor, lItem ) ) {
+                            return false;
+                        }
+
+                        aResult.push_back( std::move( lItem ) );
+                    }
+                    else if ( !SkipValue( aCursor ) ) {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                JsonVariant lValue;
+
+                if ( ReadScalar( aCursor, lValue ) != eValue::Scalar ) {
+                    return false;
+                }
+
+                std::optional<ItemT> lItem = lValue.GetValue<ItemT>();
+
+                if ( lItem.has_value() ) {
+                    aResult.push_back( std::move( lItem.value() ) );
+                }
+            } while ( NextItem( aCursor, ']', lClosed, lSuccess ) );
+
+            return lSuccess;
+        }
+
+        template<typename MEMBER>
+        bool BindElement( StructuralCursor& aCursor,
+                          MEMBER&           aMember )
+        {
+            if ( !IsContainerStart( aCursor, '{' ) ) {
+                return SkipValue( aCursor );
+            }
+
+            // a free form object is parsed on its own, it is a complete document
+            const size_t lBegin = aCursor.Offset();
+
+            if ( !SkipValue( aCursor ) ) {
+                return false;
+            }
+
+            JsonElement                         lElement;
+            MapParserNotifier                   lNotifier( lElement );
+            BasicJsonParser<MapParserNotifier>& lParser = BasicJsonParser<MapParserNotifier>::ForThread();
+
+            if ( !lParser.Parse( aCursor.Document.substr( lBegin, aCursor.After - lBegin ), lNotifier ) ) {
+                return false;
+            }
+
+            aMember.Value = std::move( lElement );
+            aMember.IsSet = true;
+            return true;
+        }
+
+        static eValue ReadScalar( StructuralCursor& aCursor,
+                                  JsonVariant&      aValue )
+        {
+            if ( aCursor.AtEnd() ) {
+                return eValue::Invalid;
+            }
+
+            const char   lChar   = aCursor.Peek();
+            const size_t lOffset = aCursor.Offset();
+
+            if ( aCursor.IsBlankUntil( lOffset ) ) {
+                if ( ( lChar == '{' ) || ( lChar == '[' ) ) {
+                    return eValue::Container;
+                }
+
+                if ( lChar != '\"' ) {
+                    return eValue::Invalid;
+                }
+
+                aCursor.Advance();
+
+                if ( aCursor.AtEnd() ) {
+                    return eValue::Invalid;
+                }
+
+                std::string lText( aCursor.Document.substr( lOffset + 1, aCursor.Offset() - lOffset - 1 ) );
+                aCursor.Advance();
+
+                if ( !text::Unescape( lText ) ) {
+                    return eValue::Invalid;
+                }
+
+                aValue = JsonVariant( std::move( lText ) );
+                return eValue::Scalar;
+            }
+
+            // a literal runs up to the next structural
+            const std::string_view lLiteral = aCursor.Span( aCursor.After, lOffset );
+            aCursor.After = lOffset;
+
+            if ( ( lLiteral == "true" ) || ( lLiteral == "false" ) ) {
+                aValue = JsonVariant( lLiteral == "true" );
+                return eValue::Scalar;
+            }
+
+            const std::optional<number::Value> lNumber = number::Parse( lLiteral );
+
+            if ( !lNumber.has_value() ) {
+                return eValue::Invalid;
+            }
+
+            std::visit( [ & ] (const auto aNumber)
+                        {
+                            aValue = JsonVariant( aNumber );
+                        }, lNumber.value() );
+            return eValue::Scalar;
+        }
+
+        static bool SkipLiteral( StructuralCursor& aCursor )
+        {
+            const std::string_view lLiteral = aCursor.Span( aCursor.After, aCursor.Offset() );
+            aCursor.After = aCursor.Offset();
+
+            return ( lLiteral == "true" )
+                   || ( lLiteral == "false" )
+                   || number::Parse( lLiteral ).has_value();
+        }
+
+        /*!
+         * Moves past one value. Containers are skipped by counting brackets in
+         * the index, strings hold no structurals so their quotes are just stepped
+         * over.
+         */
+        static bool SkipValue( StructuralCursor& aCursor )
+        {
+            if ( aCursor.AtEnd() ) {
+                return false;
+            }
+
+            if ( !aCursor.IsBlankUntil( aCursor.Offset() ) ) {
+                return SkipLiteral( aCursor );
+            }
+
+            const char lChar = aCursor.Peek();
+
+            if ( lChar == '\"' ) {
+                aCursor.Advance();
+
+                if ( aCursor.AtEnd() ) {
+                    return false;
+                }
+
+                aCursor.Advance();
+                return true;
+            }
+
+            if ( ( lChar != '{' ) && ( lChar != '[' ) ) {
+                return false;
+            }
+
+            size_t lDepth = 0;
+
+            do {
+                if ( aCursor.AtEnd() ) {
+                    return false;
+                }
+
+                const char lNext = aCursor.Peek();
+                aCursor.Advance();
+
+                if ( ( lNext == '{' ) || ( lNext == '[' ) ) {
+                    ++lDepth;
+                }
+                else if ( ( lNext == '}' ) || ( lNext == ']' ) ) {
+                    --lDepth;
+                }
+            } while ( lDepth != 0 );
+
+            return true;
+        }
+    };
+}
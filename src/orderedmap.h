@@ -0,0 +1,377 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "segmentedvector.h"
+#include "typehelpers.h"
+
+namespace jsbjson
+{
+    /*!
+     * Map keeping its entries in insertion order in a SegmentedVector.
+     * Small maps are searched linearly, from kIndexThreshold entries on an
+     * open addressing index of entry positions is kept next to the entries.
+     * Assigning to an existing key keeps its position, erasing is O(n).
+     * Adding an entry never moves the others, so references stay valid
+     * across insertions, erasing moves the entries behind the erased one.
+     * With a HASH declaring is_transparent, find, count, at and operator[]
+     * also take text and search for it without building a KEY.
+     */
+    template<typename KEY,
+             typename VALUE,
+             typename HASH      = std::hash<KEY>,
+             typename ALLOCATOR = std::allocator<std::pair<KEY, VALUE>>>
+    class OrderedMap
+    {
+    public:
+        using key_type       = KEY;
+        using mapped_type    = VALUE;
+        using value_type     = std::pair<KEY, VALUE>;
+        using allocator_type = typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<value_type>;
+        using Entries        = SegmentedVector<value_type, allocator_type>;
+        using iterator       = typename Entries::iterator;
+        using const_iterator = typename Entries::const_iterator;
+        using size_type      = size_t;
+
+        static constexpr size_t kIndexThreshold = 16;
+
+        /*!
+         * Whether K is searched for as text: it is not a KEY, converts to a
+         * std::string_view and HASH hashes text.
+         */
+        template<typename K>
+        static constexpr bool IsText()
+        {
+            return !std::is_same_v<K, KEY>
+                   && std::is_convertible_v<const K&, std::string_view>
+                   && IsTransparent<HASH>::value;
+        }
+
+        template<typename K>
+        using IfText = std::enable_if_t<IsText<K>()>;
+
+        OrderedMap() = default;
+
+        OrderedMap( std::initializer_list<value_type> aEntries )
+        {
+            for ( const value_type& lEntry : aEntries ) {
+                insert( lEntry );
+            }
+        }
+
+        iterator begin()
+        {
+            return mEntries.begin();
+        }
+
+        iterator end()
+        {
+            return mEntries.end();
+        }
+
+        const_iterator begin() const
+        {
+            return mEntries.begin();
+        }
+
+        const_iterator end() const
+        {
+            return mEntries.end();
+        }
+
+        const_iterator cbegin() const
+        {
+            return mEntries.cbegin();
+        }
+
+        const_iterator cend() const
+        {
+            return mEntries.cend();
+        }
+
+        size_t size() const
+        {
+            return mEntries.size();
+        }
+
+        bool empty() const
+        {
+            return mEntries.empty();
+        }
+
+        void clear()
+        {
+            mEntries.clear();
+            mSlots.clear();
+        }
+
+        void reserve( const size_t aCount )
+        {
+            mEntries.reserve( aCount );
+        }
+
+        allocator_type get_allocator() const
+        {
+            return mEntries.get_allocator();
+        }
+
+        void swap( OrderedMap& aOther )
+        {
+            mEntries.swap( aOther.mEntries );
+            mSlots.swap( aOther.mSlots );
+        }
+
+        iterator find( const KEY& aKey )
+        {
+            return mEntries.begin() + Position( aKey );
+        }
+
+        const_iterator find( const KEY& aKey ) const
+        {
+            return mEntries.cbegin() + Position( aKey );
+        }
+
+        template<typename K, typename = IfText<K>>
+        iterator find( const K& aText )
+        {
+            return mEntries.begin() + Position( std::string_view( aText ) );
+        }
+
+        template<typename K, typename = IfText<K>>
+        const_iterator find( const K& aText ) const
+        {
+            return mEntries.cbegin() + Position( std::string_view( aText ) );
+        }
+
+        size_t count( const KEY& aKey ) const
+        {
+            return Position( aKey ) == mEntries.size()
+                   ? 0
+                   : 1;
+        }
+
+        template<typename K, typename = IfText<K>>
+        size_t count( const K& aText ) const
+        {
+            return Position( std::string_view( aText ) ) == mEntries.size()
+                   ? 0
+                   : 1;
+        }
+
+        template<typename K, typename = IfText<K>>
+        VALUE& at( const K& aText )
+        {
+            return At( std::string_view( aText ) );
+        }
+
+        template<typename K, typename = IfText<K>>
+        const VALUE& at( const K& aText ) const
+        {
+            return const_cast<OrderedMap&>( *this ).At( std::string_view( aText ) );
+        }
+
+        VALUE& at( const KEY& aKey )
+        {
+            return At( aKey );
+        }
+
+        const VALUE& at( const KEY& aKey ) const
+        {
+            return const_cast<OrderedMap&>( *this ).At( aKey );
+        }
+
+        VALUE& operator []( const KEY& aKey )
+        {
+            return try_emplace( aKey ).first->second;
+        }
+
+        VALUE& operator []( KEY&& aKey )
+        {
+            return try_emplace( std::move( aKey ) ).first->second;
+        }
+
+        /*!
+         * A KEY is only built when the text is not in the map yet.
+         */
+        template<typename K, typename = IfText<K>>
+        VALUE& operator []( const K& aText )
+        {
+            const std::string_view lText     = aText;
+            const size_t           lPosition = Position( lText );
+
+            if ( lPosition != mEntries.size() ) {
+                return mEntries[ lPosition ].second;
+            }
+
+            return try_emplace( KEY( lText ) ).first->second;
+        }
+
+
+        template<typename K, typename... ARGS>
+        std::pair<iterator, bool> try_emplace( K&&        aKey,
+                                               ARGS&&... aArgs )
+        {
+            size_t lPosition = 0;
+
+            if constexpr ( IsText<std::decay_t<K>>() ) {
+                lPosition = Position( std::string_view( aKey ) );
+            }
+            else {
+                lPosition = Position( static_cast<const KEY&>( aKey ) );
+            }
+
+            if ( lPosition != mEntries.size() ) {
+                return { mEntries.begin() + lPosition, false };
+            }
+
+            mEntries.emplace_back( std::piecewise_construct,
+                                   std::forward_as_tuple( std::forward<K>( aKey ) ),
+                                   std::forward_as_tuple( std::forward<ARGS>( aArgs )... ) );
+            Indexed();
+            return { mEntries.begin() + ( mEntries.size() - 1 ), true };
+        }
+
+        template<typename... ARGS>
+        std::pair<iterator, bool> emplace( ARGS&&... aArgs )
+        {
+            value_type lEntry( std::forward<ARGS>( aArgs )... );
+            return insert( std::move( lEntry ) );
+        }
+
+        std::pair<iterator, bool> insert( const value_type& aEntry )
+        {
+            return try_emplace( aEntry.first, aEntry.second );
+        }
+
+        std::pair<iterator, bool> insert( value_type&& aEntry )
+        {
+            return try_emplace( std::move( aEntry.first ), std::move( aEntry.second ) );
+        }
+
+        iterator erase( const_iterator aPosition )
+        {
+            const iterator lNext = mEntries.erase( aPosition );
+            Reindex();
+            return lNext;
+        }
+
+        size_t erase( const KEY& aKey )
+        {
+            const size_t lPosition = Position( aKey );
+
+            if ( lPosition == mEntries.size() ) {
+                return 0;
+            }
+
+            erase( mEntries.cbegin() + lPosition );
+            return 1;
+        }
+
+    private:
+        template<typename K>
+        VALUE& At( const K& aKey )
+        {
+            const size_t lPosition = Position( aKey );
+
+            if ( lPosition == mEntries.size() ) {
+                throw std::out_of_range( "OrderedMap::at" );
+            }
+
+            return mEntries[ lPosition ].second;
+        }
+
+        using SlotAllocator = typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<uint32_t>;
+
+        /*!
+         * Position of aKey, a KEY or text, in mEntries, mEntries.size() when
+         * it is missing.
+         */
+        template<typename K>
+        size_t Position( const K& aKey ) const
+        {
+            if ( mSlots.empty() ) {
+                for ( size_t lPosition = 0; lPosition < mEntries.size(); ++lPosition ) {
+                    if ( mEntries[ lPosition ].first == aKey ) {
+                        return lPosition;
+                    }
+                }
+
+                return mEntries.size();
+            }
+
+            const size_t lMask = mSlots.size() - 1;
+
+            for ( size_t lSlot = HASH {}( aKey ) & lMask; mSlots[ lSlot ] != 0; lSlot = ( lSlot + 1 ) & lMask ) {
+                const size_t lPosition = mSlots[ lSlot ] - 1;
+
+                if ( mEntries[ lPosition ].first == aKey ) {
+                    return lPosition;
+                }
+            }
+
+            return mEntries.size();
+        }
+
+        /*!
+         * Adds the last entry to the index, which is built once the map is
+         * large enough and kept at most half full.
+         */
+        void Indexed()
+        {
+            if ( mEntries.size() < kIndexThreshold ) {
+                return;
+            }
+
+            if ( mEntries.size() * 2 > mSlots.size() ) {
+                Reindex();
+                return;
+            }
+
+            Slot( mEntries.size() - 1 );
+        }
+
+        void Reindex()
+        {
+            mSlots.clear();
+
+            if ( mEntries.size() < kIndexThreshold ) {
+                return;
+            }
+
+            size_t lSize = kIndexThreshold * 2;
+
+            while ( lSize < mEntries.size() * 4 ) {
+                lSize *= 2;
+            }
+
+            mSlots.assign( lSize, 0 );
+
+            for ( size_t lPosition = 0; lPosition < mEntries.size(); ++lPosition ) {
+                Slot( lPosition );
+            }
+        }
+
+        void Slot( const size_t aPosition )
+        {
+            const size_t lMask = mSlots.size() - 1;
+            size_t       lSlot = HASH {}( mEntries[ aPosition ].first ) & lMask;
+
+            while ( mSlots[ lSlot ] != 0 ) {
+                lSlot = ( lSlot + 1 ) & lMask;
+            }
+
+            mSlots[ lSlot ] = static_cast<uint32_t>( aPosition + 1 );
+        }
+
+    private:
+        Entries                              mEntries;
+        std::vector<uint32_t, SlotAllocator> mSlots;   /*!<entry position + 1 per slot, 0 when free*/
+    };
+}
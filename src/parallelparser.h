@@ -0,0 +1,349 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "structuralindex.h"
+#include "jsonstring.h"
+#include "parser.h"
+#include "mapparsernotifier.h"
+#include "jsonelementex.h"
+#include "toobject.h"
+#include "threadpool.h"
+
+namespace jsbjson
+{
+    /*!
+     * Parses a single large document on several threads. Arrays bigger than the
+     * split threshold are cut into runs of items at top level commas found in the
+     * structural index, the runs are parsed in parallel while the rest of the
+     * document is parsed with those arrays left empty, then the items are moved
+     * into place. The result equals a sequential parse.
+     */
+    class ParallelParser final
+    {
+    public:
+        explicit ParallelParser( const size_t aThreadCount   = std::thread::hardware_concurrency(),
+                                 const size_t aMinSplitBytes = size_t { 1 } << 20 )
+            : mPool( aThreadCount )
+            , mMinSplitBytes( aMinSplitBytes )
+        {}
+
+        bool Parse( const std::string_view aJsonDocument,
+                    JsonElementEx&         aResult )
+        {
+            aResult.clear();
+
+            StructuralIndex lIndex;
+
+            if ( !lIndex.Build( aJsonDocument ) ) {
+                return false;
+            }
+
+            const std::vector<SplitArray> lArrays = FindSplitArrays( aJsonDocument, lIndex.Positions() );
+
+            if ( !ParseSkeleton( aJsonDocument, lIndex.Positions(), lArrays, aResult ) ) {
+                aResult.clear();
+                return false;
+            }
+
+            std::vector<Run> lRuns;
+
+            for ( size_t lArray = 0; lArray < lArrays.size(); ++lArray ) {
+                AddRuns( aJsonDocument, lIndex.Positions(), lArrays[ lArray ], lArray, lRuns );
+            }
+
+            std::atomic<bool> lSuccess { true };
+
+            mPool.ParallelFor( lRuns.size(), [ & ] ( const size_t aRun )
+                               {
+                                   if ( !ParseRun( lRuns[ aRun ] ) ) {
+                                       lSuccess = false;
+                                   }
+                               } );
+
+            if ( !lSuccess ) {
+                aResult.clear();
+                return false;
+            }
+
+            Merge( lArrays, lRuns, aResult );
+            return true;
+        }
+
+        template<typename OBJECT>
+        std::optional<std::decay_t<OBJECT>> ParseObject( const std::string_view aJsonDocument )
+        {
+            JsonElementEx lElement;
+
+            if ( !Parse( aJsonDocument, lElement ) ) {
+                return std::nullopt;
+            }
+
+            return ToObject<OBJECT> {}.FromElement( lElement );
+        }
+
+    private:
+        using PathSegment = std::variant<std::string, size_t>;
+
+        struct SplitArray final
+        {
+            size_t                   OpenIndex  = 0;   /*!<index of '[' in the structural positions*/
+            size_t                   CloseIndex = 0;   /*!<index of the matching ']'*/
+            std::vector<PathSegment> Path;
+            bool                     Dropped = false;   /*!<a later duplicate key replaced the array*/
+        };
+
+        struct Run final
+        {
+            size_t                   Array    = 0;
+            size_t                   MaxDepth = 0;
+            std::string_view         Items;
+            std::vector<JsonVariant> Result;
+        };
+
+        struct Frame final
+        {
+            char        Type      = '{';
+            size_t      OpenIndex = 0;
+            std::string Key;
+            size_t      Item = 0;
+            std::vector<std::pair<std::string, size_t>> Splits;   /*!<keys leading to split arrays*/
+        };
+
+        std::vector<SplitArray> FindSplitArrays( const std::string_view       aJsonDocument,
+                                                 const std::vector<uint32_t>& aPositions ) const
+        {
+            std::vector<SplitArray> lArrays;
+            std::vector<Frame>      lStack;
+
+            for ( size_t lIndex = 0; lIndex < aPositions.size(); ++lIndex ) {
+                const char lChar = aJsonDocument[ aPositions[ lIndex ] ];
+
+                if ( lChar == '\"' ) {
+                    const size_t lEnd = ++lIndex;
+
+                    // a string directly followed by ':' is the key of the next member
+                    if ( !lStack.empty()
+                         && ( lStack.back().Type == '{' )
+                         && ( lEnd + 1 < aPositions.size() )
+                         && ( aJsonDocument[ aPositions[ lEnd + 1 ] ] == ':' ) )
+                    {
+                        const size_t lBegin = aPositions[ lEnd - 1 ] + 1;
+                        Frame&       lFrame = lStack.back();
+                        lFrame.Key = std::string( aJsonDocument.substr( lBegin, aPositions[ lEnd ] - lBegin ) );
+
+                        // keys are compared decoded, a bad escape is reported by the skeleton parse
+                        text::Unescape( lFrame.Key );
+
+                        // the last duplicate wins, so an array under an earlier one is left to the sequential parse
+                        for ( const auto& lSplit : lFrame.Splits ) {
+                            if ( lSplit.first == lFrame.Key ) {
+                                lArrays[ lSplit.second ].Dropped = true;
+                            }
+                        }
+                    }
+
+                    continue;
+                }
+
+                if ( ( lChar == '{' ) || ( lChar == '[' ) ) {
+                    lStack.push_back( { lChar, lIndex } );
+                    continue;
+                }
+
+                if ( ( lChar == ',' ) && !lStack.empty() && ( lStack.back().Type == '[' ) ) {
+                    ++lStack.back().Item;
+                    continue;
+                }
+
+                if ( ( lChar != ']' ) && ( lChar != '}' ) ) {
+                    continue;
+                }
+
+                if ( lStack.empty() ) {
+                    break;
+                }
+
+                const Frame lFrame = lStack.back();
+                lStack.pop_back();
+
+                if ( ( lChar != ']' )
+                     || ( lFrame.Type != '[' )
+                     || lStack.empty()
+                     || ( aPositions[ lIndex ] - aPositions[ lFrame.OpenIndex ] < mMinSplitBytes ) )
+                {
+                    continue;
+                }
+
+                // the outermost big array wins, drop the big arrays found inside it
+                while ( !lArrays.empty() && ( lArrays.back().OpenIndex > lFrame.OpenIndex ) ) {
+                    lArrays.pop_back();
+                }
+
+                SplitArray lArray { lFrame.OpenIndex, lIndex };
+
+                for ( Frame& lParent : lStack ) {
+                    while ( !lParent.Splits.empty() && ( lParent.Splits.back().second >= lArrays.size() ) ) {
+                        lParent.Splits.pop_back();
+                    }
+
+                    if ( lParent.Type == '{' ) {
+                        lArray.Path.emplace_back( lParent.Key );
+                        lParent.Splits.emplace_back( lParent.Key, lArrays.size() );
+                    }
+                    else {
+                        lArray.Path.emplace_back( lParent.Item );
+                    }
+                }
+
+                lArrays.push_back( std::move( lArray ) );
+            }
+
+            lArrays.erase( std::remove_if( lArrays.begin(), lArrays.end(), [] ( const SplitArray& aArray )
+                                           {
+                                               return aArray.Dropped;
+                                           } ),
+                           lArrays.end() );
+
+            return lArrays;
+        }
+
+        bool ParseSkeleton( const std::string_view         aJsonDocument,
+                            const std::vector<uint32_t>&   aPositions,
+                            const std::vector<SplitArray>& aArrays,
+                            JsonElementEx&                 aResult ) const
+        {
+            // the big arrays are fed without their items, that way they come out empty
+            MapParserNotifier                   lNotifier( aResult );
+            BasicJsonParser<MapParserNotifier>& lParser = BasicJsonParser<MapParserNotifier>::ForThread();
+            size_t                              lOffset = 0;
+
+            if ( !lParser.Start( lNotifier ) ) {
+                return false;
+            }
+
+            for ( const SplitArray& lArray : aArrays ) {
+                const size_t lOpen = aPositions[ lArray.OpenIndex ];
+
+                if ( !lParser.Feed( aJsonDocument.substr( lOffset, lOpen + 1 - lOffset ) ) ) {
+                    return false;
+                }
+
+                lOffset = aPositions[ lArray.CloseIndex ];
+            }
+
+            return lParser.Feed( aJsonDocument.substr( lOffset ) )
+                   && lParser.Finish();
+        }
+
+        void AddRuns( const std::string_view       aJsonDocument,
+                      const std::vector<uint32_t>& aPositions,
+                      const SplitArray&            aArray,
+                      const size_t                 aArrayNumber,
+                      std::vector<Run>&            aRuns ) const
+        {
+            const size_t lBegin       = aPositions[ aArray.OpenIndex ] + 1;
+            const size_t lEnd         = aPositions[ aArray.CloseIndex ];
+            const size_t lTargetBytes = std::max<size_t>( ( lEnd - lBegin ) / ( mPool.Size() * kRunsPerThread ), 1 );
+            size_t       lRunBegin    = lBegin;
+            size_t       lDepth       = 0;
+
+            // the run is wrapped in two containers, the array itself sits at depth Path.size() + 1
+            const size_t lMaxDepth = BasicJsonParser<MapParserNotifier>::kDefaultMaxDepth + 1 - aArray.Path.size();
+
+            for ( size_t lIndex = aArray.OpenIndex + 1; lIndex < aArray.CloseIndex; ++lIndex ) {
+                const char lChar = aJsonDocument[ aPositions[ lIndex ] ];
+
+                if ( ( lChar == '{' ) || ( lChar == '[' ) ) {
+                    ++lDepth;
+                }
+                else if ( ( lChar == '}' ) || ( lChar == ']' ) ) {
+                    --lDepth;
+                }
+                else if ( ( lChar == ',' )
+                          && ( lDepth == 0 )
+                          && ( aPositions[ lIndex ] - lRunBegin >= lTargetBytes ) )
+                {
+                    aRuns.push_back( { aArrayNumber, lMaxDepth, aJsonDocument.substr( lRunBegin, aPositions[ lIndex ] - lRunBegin ) } );
+                    lRunBegin = aPositions[ lIndex ] + 1;
+                }
+            }
+
+            aRuns.push_back( { aArrayNumber, lMaxDepth, aJsonDocument.substr( lRunBegin, lEnd - lRunBegin ) } );
+        }
+
+        static bool ParseRun( Run& aRun )
+        {
+            // the run is parsed as the only array of a synthetic object, nothing is copied
+            JsonElement                        lElement;
+            MapParserNotifier                  lNotifier( lElement );
+            BasicJsonParser<MapParserNotifier> lParser( aRun.MaxDepth );
+
+            const bool lSuccess = lParser.Start( lNotifier )
+                                  && lParser.Feed( "{\"\":[" )
+                                  && lParser.Feed( aRun.Items )
+                                  && lParser.Feed( "]}" )
+                                  && lParser.Finish();
+
+            if ( !lSuccess ) {
+                return false;
+            }
+
+            aRun.Result = std::move( lElement[ "" ].GetValueRef<std::vector<JsonVariant>>() );
+            return true;
+        }
+
+        static void Merge( const std::vector<SplitArray>& aArrays,
+                           std::vector<Run>&              aRuns,
+                           JsonElementEx&                 aResult )
+        {
+            size_t lRun = 0;
+
+            for ( size_t lArray = 0; lArray < aArrays.size(); ++lArray ) {
+                std::vector<JsonVariant>& lTarget = Find( aArrays[ lArray ].Path, aResult );
+                size_t                    lSize   = 0;
+
+                for ( size_t lIndex = lRun; ( lIndex < aRuns.size() ) && ( aRuns[ lIndex ].Array == lArray ); ++lIndex ) {
+                    lSize += aRuns[ lIndex ].Result.size();
+                }
+
+                lTarget.reserve( lSize );
+
+                for ( ; ( lRun < aRuns.size() ) && ( aRuns[ lRun ].Array == lArray ); ++lRun ) {
+                    for ( auto& lItem : aRuns[ lRun ].Result ) {
+                        lTarget.push_back( std::move( lItem ) );
+                    }
+                }
+            }
+        }
+
+        static std::vector<JsonVariant>& Find( const std::vector<PathSegment>& aPath,
+                                               JsonElementEx&                  aResult )
+        {
+            JsonVariant* lCurrent = &aResult[ std::get<std::string>( aPath.front() ) ];
+
+            for ( size_t lIndex = 1; lIndex < aPath.size(); ++lIndex ) {
+                if ( std::holds_alternative<std::string>( aPath[ lIndex ] ) ) {
+                    lCurrent = &( *lCurrent )[ std::get<std::string>( aPath[ lIndex ] ) ];
+                }
+                else {
+                    lCurrent = &lCurrent->GetValueRef<std::vector<JsonVariant>>()[ std::get<size_t>( aPath[ lIndex ] ) ];
+                }
+            }
+
+            return lCurrent->GetValueRef<std::vector<JsonVariant>>();
+        }
+
+    private:
+        static constexpr size_t kRunsPerThread = 4;
+
+        ThreadPool mPool;
+        size_t     mMinSplitBytes = 0;
+    };
+}
@@ -1,55 +1,223 @@
 #pragma once
 #include <memory>
 #include <string>
-#include <charconv>
-#include <list>
+#include <string_view>
+#include <cstring>
 #include <optional>
 #include <variant>
+#include <type_traits>
 #include "iparsernotifier.h"
+#include "iparserviewnotifier.h"
+#include "structuralindex.h"
+#include "mappedfile.h"
+#include "nestingstack.h"
+#include "numberparser.h"
+#include "jsonstring.h"
+#include "typehelpers.h"
 
 namespace jsbjson
 {
-    class JsonParser
+    /*!
+     * Parser calling the event methods of HANDLER directly, so a handler with
+     * non virtual (or final) methods gets them inlined and empty ones compiled
+     * away. HANDLER needs the methods of IParserNotifier, or of
+     * IParserViewNotifier when it derives from it, in which case names and
+     * strings are passed as views and only copied when they hold escapes or,
+     * with Feed(), when they span chunks. A handler with a bool IsDone() method
+     * ends the parse early: once it returns true no more input is read and the
+     * parse succeeds without OnParsingFinished().
+     */
+    template<typename HANDLER>
+    class BasicJsonParser
     {
     public:
-        bool Parse( const std::string&               aJsonDocument,
-                    std::shared_ptr<IParserNotifier> aNotifier )
+        static constexpr size_t kDefaultMaxDepth = 1024;
+
+        /*!
+         * Documents nested deeper than aMaxDepth objects and arrays are rejected
+         * as soon as the first container over the limit is opened.
+         */
+        explicit BasicJsonParser( const size_t aMaxDepth = kDefaultMaxDepth )
+            : mMaxDepth( aMaxDepth )
+        {}
+
+        bool Parse( const std::string_view aJsonDocument,
+                    HANDLER&               aHandler )
         {
-            if ( aNotifier == nullptr ) {
+            return Start( aHandler )
+                   && Feed( aJsonDocument )
+                   && Finish();
+        }
+
+        bool Parse( const char*  aData,
+                    const size_t aSize,
+                    HANDLER&     aHandler )
+        {
+            return Parse( std::string_view( aData, aSize ), aHandler );
+        }
+
+        bool ParseFile( const std::string& aPath,
+                        HANDLER&           aHandler )
+        {
+            const MappedFile lFile( aPath );
+
+            if ( !lFile.IsOpen() ) {
+                aHandler.OnError( "Failed to open " + aPath );
                 return false;
             }
 
-            aNotifier->OnParsingStarted();
+            return Parse( lFile.View(), aHandler );
+        }
+
+        /*!
+         * Push parsing: Start() once, Feed() the document in chunks of any size as
+         * they arrive, then Finish(). Tokens split between chunks are resumed.
+         */
+        bool Start( HANDLER& aHandler )
+        {
+            Reset();
+            mHandler = &aHandler;
+            mHandler->OnParsingStarted();
+            return true;
+        }
 
-            for ( const auto& lChar : aJsonDocument ) {
-                if ( !CallStateFunction( lChar, aNotifier ) ) {
+        bool Feed( const char*  aData,
+                   const size_t aSize )
+        {
+            return Feed( std::string_view( aData, aSize ) );
+        }
+
+        bool Feed( const std::string_view aChunk )
+        {
+            if ( mHandler == nullptr ) {
+                return false;
+            }
+
+            const char* lCursor = aChunk.data();
+            const char* lEnd    = lCursor + aChunk.size();
+
+            while ( ( lCursor != lEnd ) && !IsStopped( *mHandler ) ) {
+                if ( !CallStateFunction( lCursor, lEnd, *mHandler ) ) {
+                    mHandler = nullptr;
                     return false;
                 }
             }
 
-            if ( mInfo.Parent.empty()
+            // a name still waiting for its value must outlive the chunk
+            if constexpr ( kViewEvents ) {
+                if ( !mInfo.NameView.empty() && ( mInfo.NameView.data() != mInfo.Name.data() ) ) {
+                    mInfo.Name.assign( mInfo.NameView.data(), mInfo.NameView.size() );
+                    mInfo.NameView = mInfo.Name;
+                }
+            }
+
+            return true;
+        }
+
+        bool Finish()
+        {
+            if ( mHandler == nullptr ) {
+                return false;
+            }
+
+            HANDLER& lHandler = *mHandler;
+            mHandler = nullptr;
+
+            if ( IsStopped( lHandler ) ) {
+                return true;
+            }
+
+            if ( ( mState == eParserState::Done )
+                 && mInfo.Parent.Empty()
                  && ( mOpeningCurlyCount == 0 )
                  && ( mOpeningSquareCount == 0 ) )
             {
-                aNotifier->OnParsingFinished();
+                lHandler.OnParsingFinished();
                 return true;
             }
 
+            lHandler.OnError( "Unexpected end of json" );
             return false;
         }
 
+        bool Parse( const std::string_view aJsonDocument,
+                    const StructuralIndex& aIndex,
+                    HANDLER&               aHandler )
+        {
+            ResetState();
+            aHandler.OnParsingStarted();
+
+            if ( aJsonDocument.size() > StructuralIndex::kMaxDocumentSize ) {
+                aHandler.OnError( "Document too large" );
+                return false;
+            }
+
+            if ( !aIndex.IsFor( aJsonDocument ) ) {
+                aHandler.OnError( "Index does not belong to the document" );
+                return false;
+            }
+
+            if ( !aIndex.IsComplete() ) {
+                aHandler.OnError( "Unterminated string" );
+                return false;
+            }
+
+            if ( !ParseStructurals( aJsonDocument, aIndex.Positions(), aHandler ) ) {
+                return false;
+            }
+
+            if ( !IsStopped( aHandler ) ) {
+                aHandler.OnParsingFinished();
+            }
+
+            return true;
+        }
+
+        bool ParseIndexed( const std::string_view aJsonDocument,
+                           HANDLER&               aHandler )
+        {
+            StructuralIndex lIndex;
+            lIndex.Build( aJsonDocument );
+            return Parse( aJsonDocument, lIndex, aHandler );
+        }
+
+        /*!
+         * Drops any document in progress so the parser can take the next one.
+         * Object IDs start again from 1, the name and value buffers and the
+         * nesting stack keep their capacity. Every Parse() and Start() resets.
+         */
+        void Reset()
+        {
+            mHandler = nullptr;
+            ResetState();
+        }
+
+        /*!
+         * Parser owned by the calling thread. Reusing it keeps its buffers warm,
+         * so parsing many small documents does not allocate in the parser. It is
+         * not reentrant: a handler must not parse with it while it is in use.
+         */
+        static BasicJsonParser& ForThread()
+        {
+            thread_local BasicJsonParser tParser;
+            return tParser;
+        }
+
     private:
         enum eParserState
         {
             Init
             , InObjectBegin
+            , InNextItem
             , InItemName
             , InItemValueDelimiter
+            , InArrayBegin
             , InItemValue
             , ParseStringValue
-            , ParseBoolValue
-            , ParseNumberValue
+            , ParseLiteralValue
             , ParseValueFinish
+            , Done
+            , StateCount
         };
 
         struct ParentData final
@@ -61,26 +229,41 @@ namespace jsbjson
                 , Unknown
             };
 
-            eParent Parent;
+            eParent Parent   = Unknown;
             size_t  ParentID = 0;
         };
 
         using eValueType = IParserNotifier::eValueType;
+        static constexpr size_t kInlineDepth = 32;
+        static constexpr bool   kViewEvents  = std::is_base_of_v<IParserViewNotifier, HANDLER>;
+
+        using Value = std::conditional_t<kViewEvents,
+                                         IParserViewNotifier::Value,
+                                         std::variant<uint64_t, int64_t, double, bool, std::string>>;
+
         struct ParseInfo final
         {
-            std::string           Name;
-            std::string           Value;
-            std::list<ParentData> Parent;
-            std::list<size_t>     IDs;
-            eValueType            ValueType = eValueType::Unknown;
+            std::string                            Name;
+            std::string_view                       NameView;
+            std::string                            Value;
+            NestingStack<ParentData, kInlineDepth> Parent;
+            eValueType                             ValueType     = eValueType::Unknown;
+            bool                                   EscapePending = false;
+            bool                                   HasEscape     = false;
         };
 
+        using StateFunction = bool ( BasicJsonParser::* )( const char*&,
+                                                           const char*,
+                                                           HANDLER& );
+
     private:
-        eParserState mState = eParserState::Init;
-        ParseInfo    mInfo;
-        size_t       mOpeningCurlyCount  = 0;
-        size_t       mOpeningSquareCount = 0;
-        size_t       mObjectID           = 0;
+        eParserState                     mState = eParserState::Init;
+        ParseInfo                        mInfo;
+        size_t                           mOpeningCurlyCount  = 0;
+        size_t                           mOpeningSquareCount = 0;
+        size_t                           mObjectID           = 0;
+        size_t                           mMaxDepth           = kDefaultMaxDepth;
+        HANDLER*                         mHandler = nullptr;
 
     private:
         size_t GetNextID()
@@ -88,364 +271,896 @@ namespace jsbjson
             return ++mObjectID;
         }
 
-    private:
-        bool CallStateFunction( const char                              aChar,
-                                const std::shared_ptr<IParserNotifier>& aNotifier )
+        /*!
+         * The name of the current item, a view for IParserViewNotifier handlers.
+         */
+        decltype( auto ) CurrentName() const
         {
-            if ( mState == eParserState::Init ) {
-                return DoInit( aChar, aNotifier );
+            if constexpr ( kViewEvents ) {
+                return mInfo.NameView;
             }
-
-            if ( mState == eParserState::InObjectBegin ) {
-                return DoInObjectBegin( aChar, aNotifier );
+            else {
+                return ( mInfo.Name );
             }
+        }
 
-            if ( mState == eParserState::InItemName ) {
-                return DoInItemName( aChar, aNotifier );
+        static bool IsStopped( const HANDLER& aHandler )
+        {
+            if constexpr ( HasIsDone<HANDLER>::value ) {
+                return aHandler.IsDone();
             }
-
-            if ( mState == eParserState::InItemValueDelimiter ) {
-                return DoInItemValueDelimiter( aChar, aNotifier );
+            else {
+                return false;
             }
+        }
 
-            if ( mState == eParserState::InItemValue ) {
-                return DoInItemValue( aChar, aNotifier );
-            }
+        void ClearName()
+        {
+            mInfo.Name.clear();
+            mInfo.NameView = {};
+        }
 
-            if ( mState == eParserState::ParseStringValue ) {
-                return DoParseStringValue( aChar, aNotifier );
+        void ResetState()
+        {
+            mState = eParserState::Init;
+            ClearName();
+            mInfo.Value.clear();
+            mInfo.EscapePending = false;
+            mInfo.HasEscape     = false;
+            mInfo.Parent.Clear();
+            mInfo.ValueType     = eValueType::Unknown;
+            mOpeningCurlyCount  = 0;
+            mOpeningSquareCount = 0;
+            mObjectID           = 0;
+        }
+
+        static bool IsWhitespace( const char aChar )
+        {
+            return ( aChar == ' ' )
+                   || ( aChar == '\n' )
+                   || ( aChar == '\r' )
+                   || ( aChar == '\t' );
+        }
+
+        static bool IsLiteralChar( const char aChar )
+        {
+            return ( ( aChar >= '0' ) && ( aChar <= '9' ) )
+                   || ( ( aChar >= 'a' ) && ( aChar <= 'z' ) )
+                   || ( ( aChar >= 'A' ) && ( aChar <= 'Z' ) )
+                   || ( aChar == '-' )
+                   || ( aChar == '+' )
+                   || ( aChar == '.' );
+        }
+
+        /*!
+         * Moves aCursor to the first non whitespace char, returns false if the
+         * whole remaining input was whitespace.
+         */
+        static bool SkipWhitespace( const char*& aCursor,
+                                    const char*  aEnd )
+        {
+            while ( ( aCursor != aEnd ) && IsWhitespace( *aCursor ) ) {
+                ++aCursor;
             }
 
-            if ( mState == eParserState::ParseBoolValue ) {
-                return DoParseBoolValue( aChar, aNotifier );
+            return aCursor != aEnd;
+        }
+
+        /*!
+         * Returns the closing quote of the string continuing at aCursor or aEnd if
+         * the string continues past aEnd. aEscapePending carries a backslash that
+         * ended the previous chunk, aHasEscape is set once a backslash is seen.
+         */
+        static const char* FindStringEnd( const char* aCursor,
+                                          const char* aEnd,
+                                          bool&       aEscapePending,
+                                          bool&       aHasEscape )
+        {
+            if ( aEscapePending ) {
+                if ( aCursor == aEnd ) {
+                    return aEnd;
+                }
+
+                ++aCursor;
+                aEscapePending = false;
             }
 
-            if ( mState == eParserState::ParseNumberValue ) {
-                return DoParseNumberValue( aChar, aNotifier );
+            while ( true ) {
+                const char* lHit = text::FindQuoteOrBackslash( aCursor, aEnd );
+
+                if ( ( lHit == aEnd ) || ( *lHit == '\"' ) ) {
+                    return lHit;
+                }
+
+                aHasEscape = true;
+
+                if ( lHit + 1 == aEnd ) {
+                    aEscapePending = true;
+                    return aEnd;
+                }
+
+                aCursor = lHit + 2;
             }
+        }
+
+        void BeginString( std::string& aTarget )
+        {
+            aTarget.clear();
+            mInfo.EscapePending = false;
+            mInfo.HasEscape     = false;
+        }
 
-            if ( mState == eParserState::ParseValueFinish ) {
-                return DoParseValueFinish( aChar, aNotifier );
+        bool FinishString( std::string& aTarget,
+                           HANDLER&     aHandler )
+        {
+            if ( mInfo.HasEscape && !text::Unescape( aTarget ) ) {
+                aHandler.OnError( "Invalid escape sequence" );
+                return false;
             }
 
-            return false;
+            return true;
         }
 
     private:
-        bool DoInit( const char                              aChar,
-                     const std::shared_ptr<IParserNotifier>& aNotifier )
+        bool CallStateFunction( const char*& aCursor,
+                                const char*  aEnd,
+                                HANDLER&     aHandler )
         {
-            if ( std::isspace( aChar ) ) {
-                return true;
-            }
+            static constexpr StateFunction kStateFunctions[ eParserState::StateCount ] = {
+                &BasicJsonParser::DoInit,
+                &BasicJsonParser::DoInObjectBegin,
+                &BasicJsonParser::DoInNextItem,
+                &BasicJsonParser::DoInItemName,
+                &BasicJsonParser::DoInItemValueDelimiter,
+                &BasicJsonParser::DoInArrayBegin,
+                &BasicJsonParser::DoInItemValue,
+                &BasicJsonParser::DoParseStringValue,
+                &BasicJsonParser::DoParseLiteralValue,
+                &BasicJsonParser::DoParseValueFinish,
+                &BasicJsonParser::DoDone
+            };
 
-            if ( aChar == '{' ) {
-                const size_t lID = GetNextID();
-                mInfo.IDs.push_back( lID );
-                aNotifier->OnObjectBegin( lID, 0, "" );
-                mInfo.Parent.push_back( { ParentData::eParent::Object, lID } );
+            return ( this->*kStateFunctions[ mState ] )( aCursor, aEnd, aHandler );
+        }
 
-                mOpeningCurlyCount++;
-                mState = eParserState::InObjectBegin;
+    private:
+        bool DoInit( const char*& aCursor,
+                     const char*  aEnd,
+                     HANDLER&     aHandler )
+        {
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
                 return true;
             }
 
-            aNotifier->OnError( "Invalid json" );
-            return false;
+            if ( *aCursor != '{' ) {
+                aHandler.OnError( "Invalid json" );
+                return false;
+            }
+
+            ++aCursor;
+            return OpenContainer( ParentData::eParent::Object, aHandler );
         }
 
-        bool DoInObjectBegin( const char                              aChar,
-                              const std::shared_ptr<IParserNotifier>& aNotifier )
+        bool DoInObjectBegin( const char*& aCursor,
+                              const char*  aEnd,
+                              HANDLER&     aHandler )
         {
-            if ( mInfo.Parent.empty() ) {
-                aNotifier->OnError( "No parent!" );
-                return false;
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
+                return true;
             }
 
-            if ( std::isspace( aChar ) ) {
+            if ( *aCursor == '}' ) {
+                ++aCursor;
+                CloseContainer( aHandler );
                 return true;
             }
 
-            mInfo.Value              = {};
-            mInfo.Name               = {};
-            const ParentData lParent = mInfo.Parent.back();
+            return DoInNextItem( aCursor, aEnd, aHandler );
+        }
 
-            if ( lParent.Parent == ParentData::eParent::Object ) {
-                if ( aChar == '\"' ) {
-                    aNotifier->OnItemBegin( lParent.ParentID );
-                    mState = eParserState::InItemName;
-                    return true;
-                }
+        bool DoInNextItem( const char*& aCursor,
+                           const char*  aEnd,
+                           HANDLER&     aHandler )
+        {
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
+                return true;
+            }
 
-                aNotifier->OnError( "Invalid char..." );
+            if ( *aCursor != '\"' ) {
+                aHandler.OnError( "Invalid char..." );
                 return false;
             }
 
-            mState = eParserState::InItemValue;
-            aNotifier->OnItemBegin( lParent.ParentID );
-            return DoInItemValue( aChar, aNotifier );
+            ++aCursor;
+            BeginString( mInfo.Name );
+            mInfo.NameView = {};
+            aHandler.OnItemBegin( mInfo.Parent.Back().ParentID );
+            mState = eParserState::InItemName;
+            return true;
         }
 
-        bool DoInItemName( const char                              aChar,
-                           const std::shared_ptr<IParserNotifier>& aNotifier )
+        bool DoInItemName( const char*& aCursor,
+                           const char*  aEnd,
+                           HANDLER&     aHandler )
         {
-            if ( aChar == '\"' ) {
-                aNotifier->OnItemName( mInfo.Name, mInfo.Parent.back().ParentID );
-                mState = eParserState::InItemValueDelimiter;
-                return true;
+            const char* lQuote = FindStringEnd( aCursor, aEnd, mInfo.EscapePending, mInfo.HasEscape );
+
+            if ( IsWholeInChunk( lQuote, aEnd, mInfo.Name ) ) {
+                mInfo.NameView = std::string_view( aCursor, static_cast<size_t>( lQuote - aCursor ) );
             }
+            else {
+                mInfo.Name.append( aCursor, lQuote );
+
+                if ( lQuote == aEnd ) {
+                    aCursor = aEnd;
+                    return true;
+                }
+
+                if ( !FinishString( mInfo.Name, aHandler ) ) {
+                    return false;
+                }
 
-            mInfo.Name += aChar;
+                mInfo.NameView = mInfo.Name;
+            }
+
+            aCursor = lQuote + 1;
+            aHandler.OnItemName( CurrentName(), mInfo.Parent.Back().ParentID );
+            mState = eParserState::InItemValueDelimiter;
             return true;
         }
 
-        bool DoInItemValueDelimiter( const char                              aChar,
-                                     const std::shared_ptr<IParserNotifier>& aNotifier )
+        bool DoInItemValueDelimiter( const char*& aCursor,
+                                     const char*  aEnd,
+                                     HANDLER&     aHandler )
         {
-            if ( std::isspace( aChar ) ) {
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
                 return true;
             }
 
-            if ( aChar == ':' ) {
+            if ( *aCursor == ':' ) {
+                ++aCursor;
                 mState = eParserState::InItemValue;
                 return true;
             }
 
-            aNotifier->OnError( std::string( "Expected \":\"" ) );
+            aHandler.OnError( std::string( "Expected \":\"" ) );
             return false;
         }
 
-        bool DoInItemValue( const char                              aChar,
-                            const std::shared_ptr<IParserNotifier>& aNotifier )
+        bool DoInArrayBegin( const char*& aCursor,
+                             const char*  aEnd,
+                             HANDLER&     aHandler )
         {
-            if ( std::isspace( aChar ) ) {
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
                 return true;
             }
 
-            mInfo.Value = {};
-
-            if ( aChar == '[' ) {
-                const size_t lID = GetNextID();
-                aNotifier->OnArrayBegin( lID, mInfo.Parent.back().ParentID, mInfo.Name );
-                mInfo.Name = {};
-                mInfo.Parent.push_back( { ParentData::eParent::Array, lID } );
-                mInfo.IDs.push_back( lID );
-                mOpeningSquareCount++;
-                mState = eParserState::InItemValue;
+            if ( *aCursor == ']' ) {
+                ++aCursor;
+                CloseContainer( aHandler );
                 return true;
             }
 
-            if ( aChar == '{' ) {
-                const size_t lID = GetNextID();
-                aNotifier->OnObjectBegin( lID, mInfo.Parent.back().ParentID, mInfo.Name );
-                mInfo.Parent.push_back( { ParentData::eParent::Object, lID } );
-                mInfo.IDs.push_back( lID );
-                mOpeningCurlyCount++;
-                mState = eParserState::InObjectBegin;
+            mState = eParserState::InItemValue;
+            return DoInItemValue( aCursor, aEnd, aHandler );
+        }
+
+        bool DoInItemValue( const char*& aCursor,
+                            const char*  aEnd,
+                            HANDLER&     aHandler )
+        {
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
                 return true;
             }
 
-            if ( aChar == '\"' ) {
-                mInfo.ValueType = eValueType::String;
-                aNotifier->OnItemValueBegin( mInfo.ValueType );
-                mState = eParserState::ParseStringValue;
-                return true;
+            const char lChar = *aCursor;
+
+            if ( lChar == '{' ) {
+                ++aCursor;
+                return OpenContainer( ParentData::eParent::Object, aHandler );
             }
 
-            if ( ( std::toupper( aChar ) == 'T' )
-                 || ( std::toupper( aChar ) == 'F' ) )
-            {
-                mInfo.ValueType = eValueType::Bool;
-                mInfo.Value     = aChar;
-                aNotifier->OnItemValueBegin( mInfo.ValueType );
-                mState = eParserState::ParseBoolValue;
-                return true;
+            if ( lChar == '[' ) {
+                ++aCursor;
+                return OpenContainer( ParentData::eParent::Array, aHandler );
             }
 
-            if ( ( aChar == '+' )
-                 || ( aChar == '-' )
-                 || ( aChar == '.' )
-                 || std::isdigit( aChar ) )
-            {
-                mInfo.ValueType = eValueType::Number;
-                mInfo.Value     = aChar;
-                aNotifier->OnItemValueBegin( mInfo.ValueType );
-                mState = eParserState::ParseNumberValue;
+            BeginString( mInfo.Value );
+
+            if ( lChar == '\"' ) {
+                ++aCursor;
+                mInfo.ValueType = eValueType::String;
+                aHandler.OnItemValueBegin( mInfo.ValueType );
+                mState = eParserState::ParseStringValue;
                 return true;
             }
 
-            aNotifier->OnError( "Failed to parse..." );
+            if ( IsLiteralChar( lChar ) ) {
+                mState = eParserState::ParseLiteralValue;
+                return DoParseLiteralValue( aCursor, aEnd, aHandler );
+            }
+
+            aHandler.OnError( "Failed to parse..." );
             return false;
         }
 
-        void NotifyItemValue( const std::shared_ptr<IParserNotifier>&                           aNotifier,
-                              const std::variant<uint64_t, int64_t, double, bool, std::string>& aValue )
+        void NotifyItemValue( HANDLER&     aHandler,
+                              const Value& aValue )
         {
-            aNotifier->OnItemValue( aValue, mInfo.Parent.back().ParentID, mInfo.Name );
+            aHandler.OnItemValue( aValue, mInfo.Parent.Back().ParentID, CurrentName() );
         }
 
-        bool DoParseStringValue( const char                              aChar,
-                                 const std::shared_ptr<IParserNotifier>& aNotifier )
+        /*!
+         * Notifies a finished string. aText is either a view of the input or of
+         * mInfo.Value, a std::string event takes mInfo.Value over instead.
+         */
+        void NotifyString( HANDLER&               aHandler,
+                           const std::string_view aText )
         {
-            if ( aChar == '\"' ) {
-                NotifyItemValue( aNotifier, mInfo.Value );
-                mState = eParserState::ParseValueFinish;
-                return true;
+            if constexpr ( kViewEvents ) {
+                NotifyItemValue( aHandler, Value( std::in_place_type<std::string_view>, aText ) );
             }
+            else {
+                NotifyItemValue( aHandler, std::move( mInfo.Value ) );
+            }
+        }
 
-            mInfo.Value += aChar;
-            return true;
+        /*!
+         * True when a view handler can get the string ending at aQuote straight
+         * from the chunk: it started in this chunk and holds no escapes.
+         */
+        bool IsWholeInChunk( const char*        aQuote,
+                             const char*        aEnd,
+                             const std::string& aBuffer ) const
+        {
+            if constexpr ( kViewEvents ) {
+                return ( aQuote != aEnd ) && aBuffer.empty() && !mInfo.HasEscape;
+            }
+            else {
+                return false;
+            }
         }
 
-        bool DoParseBoolValue( const char                              aChar,
-                               const std::shared_ptr<IParserNotifier>& aNotifier )
+        bool DoParseStringValue( const char*& aCursor,
+                                 const char*  aEnd,
+                                 HANDLER&     aHandler )
         {
-            if ( ( mInfo.Value == "true" )
-                 || ( mInfo.Value == "false" ) )
-            {
-                const bool lValue = mInfo.Value == "true"
-                                    ? true
-                                    : false;
-                NotifyItemValue( aNotifier, lValue );
-                mState = eParserState::ParseValueFinish;
-                return DoParseValueFinish( aChar, aNotifier );
+            const char* lQuote = FindStringEnd( aCursor, aEnd, mInfo.EscapePending, mInfo.HasEscape );
+
+            if ( IsWholeInChunk( lQuote, aEnd, mInfo.Value ) ) {
+                NotifyString( aHandler, std::string_view( aCursor, static_cast<size_t>( lQuote - aCursor ) ) );
+            }
+            else {
+                mInfo.Value.append( aCursor, lQuote );
+
+                if ( lQuote == aEnd ) {
+                    aCursor = aEnd;
+                    return true;
+                }
+
+                if ( !FinishString( mInfo.Value, aHandler ) ) {
+                    return false;
+                }
+
+                NotifyString( aHandler, mInfo.Value );
             }
 
-            mInfo.Value += aChar;
+            aCursor = lQuote + 1;
+            mState  = eParserState::ParseValueFinish;
             return true;
         }
 
-        template<typename NUMBER>
-        std::optional<std::variant<int64_t, uint64_t, double>> GetNumber( const std::string& aString )
+        bool DoParseLiteralValue( const char*& aCursor,
+                                  const char*  aEnd,
+                                  HANDLER&     aHandler )
         {
-            NUMBER lNumber {};
-            auto [ lPtr, lErrorCode ] = std::from_chars( aString.data(), aString.data() + aString.size(), lNumber );
+            const char* lLiteralEnd = aCursor;
 
-            if ( ( lPtr == aString.data() + aString.size() )
-                 && ( lErrorCode == std::errc() ) )
-            {
-                std::variant<int64_t, uint64_t, double> lVariant;
-                lVariant.emplace<NUMBER>( lNumber );
-                return lVariant;
+            while ( ( lLiteralEnd != aEnd ) && IsLiteralChar( *lLiteralEnd ) ) {
+                ++lLiteralEnd;
+            }
+
+            // a literal that does not span chunks is converted straight from the input
+            if ( ( lLiteralEnd != aEnd ) && mInfo.Value.empty() ) {
+                const std::string_view lLiteral( aCursor, static_cast<size_t>( lLiteralEnd - aCursor ) );
+                aCursor = lLiteralEnd;
+
+                if ( !NotifyLiteral( lLiteral, aHandler ) ) {
+                    return false;
+                }
+
+                mState = eParserState::ParseValueFinish;
+                return true;
+            }
+
+            mInfo.Value.append( aCursor, lLiteralEnd );
+            aCursor = lLiteralEnd;
+
+            if ( lLiteralEnd == aEnd ) {
+                return true;
+            }
+
+            if ( !NotifyLiteral( mInfo.Value, aHandler ) ) {
+                return false;
             }
 
-            return std::nullopt;
+            mState = eParserState::ParseValueFinish;
+            return true;
         }
 
-        template<typename HEAD, typename... TAIL>
-        std::optional<std::variant<int64_t, uint64_t, double>> ToNumber( const std::string& aString )
+        bool DoParseValueFinish( const char*& aCursor,
+                                 const char*  aEnd,
+                                 HANDLER&     aHandler )
         {
-            if constexpr ( sizeof...( TAIL ) == 0 ) {
-                return GetNumber<HEAD>( aString );
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
+                return true;
             }
-            else {
-                auto lNumber = GetNumber<HEAD>( aString );
 
-                if ( lNumber.has_value() ) {
-                    return lNumber;
+            const char lChar     = *aCursor;
+            const bool lInObject = mInfo.Parent.Back().Parent == ParentData::eParent::Object;
+
+            if ( lChar == ',' ) {
+                ++aCursor;
+                aHandler.OnNextItem();
+
+                if ( lInObject ) {
+                    mState = eParserState::InNextItem;
+                }
+                else {
+                    ClearName();
+                    mState = eParserState::InItemValue;
                 }
 
-                return ToNumber<TAIL...>( aString );
+                return true;
+            }
+
+            if ( ( lInObject && ( lChar == '}' ) )
+                 || ( !lInObject && ( lChar == ']' ) ) )
+            {
+                ++aCursor;
+                CloseContainer( aHandler );
+                return true;
+            }
+
+            aHandler.OnError( "Expected separator" );
+            return false;
+        }
+
+        bool DoDone( const char*& aCursor,
+                     const char*  aEnd,
+                     HANDLER&     aHandler )
+        {
+            if ( !SkipWhitespace( aCursor, aEnd ) ) {
+                return true;
             }
 
-            return std::nullopt;
+            aHandler.OnError( "Unexpected data after json" );
+            return false;
         }
 
-        bool DoParseNumberValue( const char                              aChar,
-                                 const std::shared_ptr<IParserNotifier>& aNotifier )
+    private:
+        bool ParseStructurals( const std::string_view       aJsonDocument,
+                               const std::vector<uint32_t>& aPositions,
+                               HANDLER&                     aHandler )
         {
-            if ( ( aChar == ',' )
-                 || ( aChar == ']' )
-                 || ( aChar == '}' )
-                 || std::isspace( aChar ) )
+            StructuralCursor lCursor { aJsonDocument, aPositions };
+
+            if ( lCursor.AtEnd()
+                 || ( lCursor.Peek() != '{' )
+                 || !lCursor.IsBlankUntil( lCursor.Offset() ) )
             {
-                std::optional<std::variant<int64_t, uint64_t, double>> lResult = ToNumber<uint64_t, int64_t, double>( mInfo.Value );
-
-                if ( lResult.has_value() ) {
-                    std::variant<uint64_t, int64_t, double, bool, std::string> lValue;
-
-                    if ( lResult.has_value() ) {
-                        std::visit( [ & ] (auto aValue)
-                                    {
-                                        lValue = aValue;
-                                    }, lResult.value() );
-                        NotifyItemValue( aNotifier, lValue );
-                        mState = eParserState::ParseValueFinish;
-                        return DoParseValueFinish( aChar, aNotifier );
+                aHandler.OnError( "Invalid json" );
+                return false;
+            }
+
+            lCursor.Advance();
+
+            if ( !OpenContainer( ParentData::eParent::Object, aHandler ) ) {
+                return false;
+            }
+
+            bool lJustOpened = true;
+
+            while ( !mInfo.Parent.Empty() ) {
+                if ( IsStopped( aHandler ) ) {
+                    return true;
+                }
+
+                if ( lCursor.AtEnd() ) {
+                    aHandler.OnError( "Unexpected end of json" );
+                    return false;
+                }
+
+                const bool lInObject = mInfo.Parent.Back().Parent == ParentData::eParent::Object;
+                const char lClosing  = lInObject
+                                       ? '}'
+                                       : ']';
+
+                if ( lJustOpened
+                     && ( lCursor.Peek() == lClosing )
+                     && lCursor.IsBlankUntil( lCursor.Offset() ) )
+                {
+                    lCursor.Advance();
+                    CloseContainer( aHandler );
+                    lJustOpened = false;
+
+                    if ( !FinishIndexedValue( lCursor, aHandler ) ) {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                lJustOpened = false;
+
+                if ( lInObject && !ParseIndexedName( lCursor, aHandler ) ) {
+                    return false;
+                }
+
+                if ( lCursor.AtEnd() ) {
+                    aHandler.OnError( "Unexpected end of json" );
+                    return false;
+                }
+
+                const char   lChar   = lCursor.Peek();
+                const size_t lOffset = lCursor.Offset();
+
+                if ( !lCursor.IsBlankUntil( lOffset ) ) {
+                    // a bare literal (number or bool) ends at the next separator
+                    const std::string_view lLiteral = lCursor.Span( lCursor.After, lOffset );
+
+                    if ( !NotifyLiteral( lLiteral, aHandler ) ) {
+                        return false;
+                    }
+
+                    lCursor.After = lOffset;
+
+                    if ( !FinishIndexedValue( lCursor, aHandler ) ) {
+                        return false;
                     }
+
+                    continue;
                 }
 
-                aNotifier->OnError( "Value is not a number: " + mInfo.Value );
+                lCursor.Advance();
+
+                if ( lChar == '{' ) {
+                    if ( !OpenContainer( ParentData::eParent::Object, aHandler ) ) {
+                        return false;
+                    }
+
+                    lJustOpened = true;
+                    continue;
+                }
+
+                if ( lChar == '[' ) {
+                    if ( !OpenContainer( ParentData::eParent::Array, aHandler ) ) {
+                        return false;
+                    }
+
+                    lJustOpened = true;
+                    continue;
+                }
+
+                if ( lChar == '\"' ) {
+                    const size_t lEnd = lCursor.Offset();
+                    lCursor.Advance();
+                    mInfo.ValueType = eValueType::String;
+                    aHandler.OnItemValueBegin( mInfo.ValueType );
+
+                    std::string_view lText;
+
+                    if ( !ReadIndexedString( aJsonDocument.substr( lOffset + 1, lEnd - lOffset - 1 ), mInfo.Value, lText, aHandler ) ) {
+                        return false;
+                    }
+
+                    NotifyString( aHandler, lText );
+
+                    if ( !FinishIndexedValue( lCursor, aHandler ) ) {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                aHandler.OnError( "Failed to parse..." );
+                return false;
+            }
+
+            if ( !lCursor.AtEnd() || !lCursor.IsBlankUntil( aJsonDocument.size() ) ) {
+                aHandler.OnError( "Unexpected data after json" );
                 return false;
             }
 
-            mInfo.Value += aChar;
             return true;
         }
 
-        bool DoParseValueFinish( const char                              aChar,
-                                 const std::shared_ptr<IParserNotifier>& aNotifier )
+        bool ParseIndexedName( StructuralCursor& aCursor,
+                               HANDLER&          aHandler )
         {
-            if ( mInfo.Parent.empty() ) {
+            if ( ( aCursor.Peek() != '\"' ) || !aCursor.IsBlankUntil( aCursor.Offset() ) ) {
+                aHandler.OnError( "Invalid char..." );
                 return false;
             }
 
-            const ParentData lParent = mInfo.Parent.back();
+            const size_t lBegin = aCursor.Offset();
+            aCursor.Advance();
+            const size_t lEnd = aCursor.Offset();
+            aCursor.Advance();
 
-            if ( lParent.Parent == ParentData::eParent::Object ) {
-                if ( aChar == ',' ) {
-                    aNotifier->OnNextItem();
-                    mState = eParserState::InObjectBegin;
-                    return true;
-                }
+            const size_t lParentID = mInfo.Parent.Back().ParentID;
+            aHandler.OnItemBegin( lParentID );
 
-                if ( aChar == '}' ) {
-                    if ( mOpeningCurlyCount == 0 ) {
-                        return false;
-                    }
+            if ( !ReadIndexedString( aCursor.Document.substr( lBegin + 1, lEnd - lBegin - 1 ), mInfo.Name, mInfo.NameView, aHandler ) ) {
+                return false;
+            }
 
-                    mOpeningCurlyCount--;
-                    mInfo.Parent.pop_back();
-                    aNotifier->OnObjectFinished( mInfo.IDs.back() );
-                    mInfo.IDs.pop_back();
-                    return true;
-                }
+            aHandler.OnItemName( CurrentName(), lParentID );
 
+            if ( aCursor.AtEnd()
+                 || ( aCursor.Peek() != ':' )
+                 || !aCursor.IsBlankUntil( aCursor.Offset() ) )
+            {
+                aHandler.OnError( std::string( "Expected \":\"" ) );
                 return false;
             }
 
-            if ( aChar == ',' ) {
-                aNotifier->OnNextItem();
-                mState = eParserState::InItemValue;
+            aCursor.Advance();
+            return true;
+        }
+
+        /*!
+         * Sets aText to the decoded string. View handlers get aRaw itself unless
+         * it holds escapes, otherwise it is decoded into aTarget.
+         */
+        bool ReadIndexedString( const std::string_view aRaw,
+                                std::string&           aTarget,
+                                std::string_view&      aText,
+                                HANDLER&               aHandler )
+        {
+            // the index only holds unescaped quotes, so any hit inside the body is a backslash
+            const bool lHasEscape = text::FindQuoteOrBackslash( aRaw.data(), aRaw.data() + aRaw.size() ) != aRaw.data() + aRaw.size();
+
+            if ( kViewEvents && !lHasEscape ) {
+                aText = aRaw;
                 return true;
             }
 
-            if ( aChar == ']' ) {
-                if ( mOpeningSquareCount == 0 ) {
-                    return false;
-                }
+            aTarget.assign( aRaw.data(), aRaw.size() );
 
-                aNotifier->OnArrayFinished( mInfo.IDs.back() );
-                mOpeningSquareCount--;
-                mInfo.Parent.pop_back();
-                mInfo.IDs.pop_back();
+            if ( lHasEscape && !text::Unescape( aTarget ) ) {
+                aHandler.OnError( "Invalid escape sequence" );
+                return false;
+            }
+
+            aText = aTarget;
+            return true;
+        }
+
+        bool FinishIndexedValue( StructuralCursor& aCursor,
+                                 HANDLER&          aHandler )
+        {
+            if ( mInfo.Parent.Empty() ) {
                 return true;
             }
 
-            if ( aChar == '}' ) {
-                if ( mOpeningCurlyCount == 0 ) {
-                    return false;
+            if ( aCursor.AtEnd() || !aCursor.IsBlankUntil( aCursor.Offset() ) ) {
+                aHandler.OnError( "Expected separator" );
+                return false;
+            }
+
+            const char lChar = aCursor.Peek();
+
+            if ( lChar == ',' ) {
+                aCursor.Advance();
+                aHandler.OnNextItem();
+
+                if ( mInfo.Parent.Back().Parent == ParentData::eParent::Array ) {
+                    ClearName();
                 }
 
-                mOpeningCurlyCount--;
-                aNotifier->OnObjectFinished( mInfo.IDs.back() );
-                mInfo.IDs.pop_back();
                 return true;
             }
 
+            const bool lIsObject = mInfo.Parent.Back().Parent == ParentData::eParent::Object;
+
+            if ( ( lIsObject && ( lChar == '}' ) )
+                 || ( !lIsObject && ( lChar == ']' ) ) )
+            {
+                aCursor.Advance();
+                CloseContainer( aHandler );
+                return FinishIndexedValue( aCursor, aHandler );
+            }
+
+            aHandler.OnError( "Expected separator" );
             return false;
         }
-    }
 
-    ;
+        bool OpenContainer( const typename ParentData::eParent aType,
+                            HANDLER&                           aHandler )
+        {
+            if ( mInfo.Parent.Size() >= mMaxDepth ) {
+                aHandler.OnError( "Maximum nesting depth exceeded" );
+                return false;
+            }
+
+            const size_t lID       = GetNextID();
+            const size_t lParentID = mInfo.Parent.Empty()
+                                     ? 0
+                                     : mInfo.Parent.Back().ParentID;
+
+            if ( aType == ParentData::eParent::Object ) {
+                aHandler.OnObjectBegin( lID, lParentID, CurrentName() );
+                mOpeningCurlyCount++;
+            }
+            else {
+                aHandler.OnArrayBegin( lID, lParentID, CurrentName() );
+                mOpeningSquareCount++;
+            }
+
+            mInfo.Parent.Push( { aType, lID } );
+            ClearName();
+            mState = aType == ParentData::eParent::Object
+                     ? eParserState::InObjectBegin
+                     : eParserState::InArrayBegin;
+            return true;
+        }
+
+        void CloseContainer( HANDLER& aHandler )
+        {
+            if ( mInfo.Parent.Back().Parent == ParentData::eParent::Object ) {
+                mOpeningCurlyCount--;
+                aHandler.OnObjectFinished( mInfo.Parent.Back().ParentID );
+            }
+            else {
+                mOpeningSquareCount--;
+                aHandler.OnArrayFinished( mInfo.Parent.Back().ParentID );
+            }
+
+            mInfo.Parent.Pop();
+            mState = mInfo.Parent.Empty()
+                     ? eParserState::Done
+                     : eParserState::ParseValueFinish;
+        }
+
+        bool NotifyLiteral( const std::string_view aLiteral,
+                            HANDLER&               aHandler )
+        {
+            if ( ( aLiteral == "true" ) || ( aLiteral == "false" ) ) {
+                mInfo.ValueType = eValueType::Bool;
+                aHandler.OnItemValueBegin( mInfo.ValueType );
+                NotifyItemValue( aHandler, aLiteral == "true" );
+                return true;
+            }
+
+            const std::optional<number::Value> lResult = number::Parse( aLiteral );
+
+            if ( !lResult.has_value() ) {
+                aHandler.OnError( "Value is not a number: " + std::string( aLiteral ) );
+                return false;
+            }
+
+            mInfo.ValueType = eValueType::Number;
+            aHandler.OnItemValueBegin( mInfo.ValueType );
+
+            Value lValue;
+            std::visit( [ & ] (auto aValue)
+                        {
+                            lValue = aValue;
+                        }, lResult.value() );
+            NotifyItemValue( aHandler, lValue );
+            return true;
+        }
+    };
+
+    /*!
+     * Parser taking a shared IParserNotifier, events go through its virtual
+     * methods. The notifier is kept alive from Start() to Finish().
+     */
+    class JsonParser final
+    {
+    public:
+        static constexpr size_t kDefaultMaxDepth = BasicJsonParser<IParserNotifier>::kDefaultMaxDepth;
+
+        explicit JsonParser( const size_t aMaxDepth = kDefaultMaxDepth )
+            : mParser( aMaxDepth )
+        {}
+
+        bool Parse( const std::string_view           aJsonDocument,
+                    std::shared_ptr<IParserNotifier> aNotifier )
+        {
+            return Start( aNotifier )
+                   && Feed( aJsonDocument )
+                   && Finish();
+        }
+
+        bool Parse( const char*                      aData,
+                    const size_t                     aSize,
+                    std::shared_ptr<IParserNotifier> aNotifier )
+        {
+            return Parse( std::string_view( aData, aSize ), aNotifier );
+        }
+
+        bool ParseFile( const std::string&               aPath,
+                        std::shared_ptr<IParserNotifier> aNotifier )
+        {
+            if ( aNotifier == nullptr ) {
+                return false;
+            }
+
+            return mParser.ParseFile( aPath, *aNotifier );
+        }
+
+        bool Start( std::shared_ptr<IParserNotifier> aNotifier )
+        {
+            mNotifier = aNotifier;
+
+            if ( mNotifier == nullptr ) {
+                return false;
+            }
+
+            return mParser.Start( *mNotifier );
+        }
+
+        bool Feed( const char*  aData,
+                   const size_t aSize )
+        {
+            return Feed( std::string_view( aData, aSize ) );
+        }
+
+        bool Feed( const std::string_view aChunk )
+        {
+            if ( mNotifier == nullptr ) {
+                return false;
+            }
+
+            if ( !mParser.Feed( aChunk ) ) {
+                mNotifier = nullptr;
+                return false;
+            }
+
+            return true;
+        }
+
+        bool Finish()
+        {
+            if ( mNotifier == nullptr ) {
+                return false;
+            }
+
+            const std::shared_ptr<IParserNotifier> lNotifier = std::move( mNotifier );
+            return mParser.Finish();
+        }
+
+        bool Parse( const std::string_view           aJsonDocument,
+                    const StructuralIndex&           aIndex,
+                    std::shared_ptr<IParserNotifier> aNotifier )
+        {
+            if ( aNotifier == nullptr ) {
+                return false;
+            }
+
+            return mParser.Parse( aJsonDocument, aIndex, *aNotifier );
+        }
+
+        bool ParseIndexed( const std::string_view           aJsonDocument,
+                           std::shared_ptr<IParserNotifier> aNotifier )
+        {
+            if ( aNotifier == nullptr ) {
+                return false;
+            }
+
+            return mParser.ParseIndexed( aJsonDocument, *aNotifier );
+        }
+
+        void Reset()
+        {
+            mNotifier = nullptr;
+            mParser.Reset();
+        }
+
+    private:
+        BasicJsonParser<IParserNotifier> mParser;
+        std::shared_ptr<IParserNotifier> mNotifier;
+    };
 }
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "iparserviewnotifier.h"
+#include "parser.h"
+#include "structuralindex.h"
+#include "jsonelement.h"
+#include "jsonkey.h"
+#include "jsonpointer.h"
+
+namespace jsbjson
+{
+    /*!
+     * Pulls the values at a set of RFC 6901 JSON Pointers ("/price/value",
+     * "/arrayOfObjects/3/name") out of a document without building its DOM.
+     * Only the matched values are built, every other subtree is passed over
+     * by depth counting, and parsing stops as soon as all pointers resolved.
+     * Because of that the first of duplicate keys wins. Malformed pointers
+     * never resolve.
+     */
+    class PointerExtractor final
+    {
+    public:
+        explicit PointerExtractor( const std::vector<std::string>& aPointers )
+            : mHandler( aPointers )
+        {}
+
+        /*!
+         * Sets aValues to one entry per pointer, empty where the pointer did not
+         * resolve. Returns false if the document is invalid up to the point
+         * where the last pointer resolved.
+         */
+        bool Extract( const std::string_view                   aJsonDocument,
+                      std::vector<std::optional<JsonVariant>>& aValues )
+        {
+            const bool lSuccess = mParser.Parse( aJsonDocument, mHandler );
+            aValues = mHandler.TakeValues();
+            return lSuccess;
+        }
+
+        /*!
+         * Streaming use: Start(), Feed() chunks until IsDone() or the input ends,
+         * then Finish(). Input after IsDone() need not be read at all.
+         */
+        bool Start()
+        {
+            return mParser.Start( mHandler );
+        }
+
+        bool Feed( const std::string_view aChunk )
+        {
+            return mParser.Feed( aChunk );
+        }
+
+        bool IsDone() const
+        {
+            return mHandler.IsDone();
+        }
+
+        bool Finish( std::vector<std::optional<JsonVariant>>& aValues )
+        {
+            const bool lSuccess = mParser.Finish();
+            aValues = mHandler.TakeValues();
+            return lSuccess;
+        }
+
+    private:
+        struct Pointer final
+        {
+            std::vector<pointer::Token> Tokens;
+            bool                        Valid = true;
+        };
+
+        struct Frame final
+        {
+            bool   IsArray   = false;
+            size_t NextIndex = 0;
+            size_t LiveBegin = 0;   /*!<pointers still matching, a range of mLive*/
+        };
+
+        class Handler final : public IParserViewNotifier
+        {
+        public:
+            explicit Handler( const std::vector<std::string>& aPointers )
+            {
+                for ( const std::string& lPointer : aPointers ) {
+                    Pointer lParsed;
+                    lParsed.Valid = pointer::Parse( lPointer, lParsed.Tokens );
+                    mPointers.push_back( std::move( lParsed ) );
+                }
+            }
+
+            bool IsDone() const
+            {
+                return mUnresolved == 0;
+            }
+
+            std::vector<std::optional<JsonVariant>> TakeValues()
+            {
+                return std::move( mValues );
+            }
+
+            void OnParsingStarted() override
+            {
+                mValues.assign( mPointers.size(), std::nullopt );
+                mFrames.clear();
+                mLive.clear();
+                mMatches.clear();
+                mCapture.clear();
+                mCaptureTargets.clear();
+                mSkipDepth  = 0;
+                mUnresolved = 0;
+
+                // the root is the only value without a parent frame, "" matches it
+                for ( size_t lIndex = 0; lIndex < mPointers.size(); ++lIndex ) {
+                    if ( !mPointers[ lIndex ].Valid ) {
+                        continue;
+                    }
+
+                    ++mUnresolved;
+
+                    if ( mPointers[ lIndex ].Tokens.empty() ) {
+                        mMatches.push_back( lIndex );
+                    }
+                    else {
+                        mLive.push_back( lIndex );
+                    }
+                }
+            }
+
+            void OnObjectBegin( const size_t           aID,
+                                const size_t           aParentID,
+                                const std::string_view aName ) override
+            {
+                BeginContainer( false, aName, JsonElement {} );
+            }
+
+            void OnObjectFinished( const size_t aID ) override
+            {
+                EndContainer();
+            }
+
+            void OnItemBegin( const size_t aParentID ) override
+            {}
+
+            void OnItemName( const std::string_view aName,
+                             const size_t           aParentID ) override
+            {}
+
+            void OnItemValueBegin( const eValueType aType ) override
+            {}
+
+            void OnItemValue( const Value&           aValue,
+                              const size_t           aParentID,
+                              const std::string_view aName ) override
+            {
+                if ( mSkipDepth != 0 ) {
+                    return;
+                }
+
+                const size_t lMatchBegin = mMatches.size();
+                const size_t lLiveBegin  = mLive.size();
+
+                MatchChild( aName );
+
+                if ( mCapture.empty() && ( mMatches.size() == lMatchBegin ) ) {
+                    mLive.resize( lLiveBegin );
+                    return;
+                }
+
+                JsonVariant lValue = ToVariant( aValue );
+
+                for ( size_t lIndex = lMatchBegin; lIndex < mMatches.size(); ++lIndex ) {
+                    Resolve( mMatches[ lIndex ], lValue );
+                }
+
+                if ( !mCapture.empty() ) {
+                    Append( aName, std::move( lValue ) );
+                }
+
+                mMatches.resize( lMatchBegin );
+                mLive.resize( lLiveBegin );
+            }
+
+            void OnArrayBegin( const size_t           aID,
+                               const size_t           aParentID,
+                               const std::string_view aName ) override
+            {
+                BeginContainer( true, aName, std::vector<JsonVariant> {} );
+            }
+
+            void OnNextItem() override
+            {}
+
+            void OnArrayFinished( const size_t aID ) override
+            {
+                EndContainer();
+            }
+
+            void OnParsingFinished() override
+            {}
+
+            void OnError( const std::string& aError ) override
+            {}
+
+        private:
+            static JsonVariant ToVariant( const Value& aValue )
+            {
+                return std::visit( [] ( const auto aItem ) -> JsonVariant
+                                   {
+                                       if constexpr ( std::is_same_v<decltype( aItem ), const std::string_view> ) {
+                                           return JsonVariant( std::string( aItem ) );
+                                       }
+                                       else {
+                                           return JsonVariant( aItem );
+                                       }
+                                   }, aValue );
+            }
+
+            /*!
+             * Sorts the pointers live in the current frame into those the child
+             * completes (appended to mMatches) and those continuing below it
+             * (appended to mLive). The root has no frame, its matches are set up
+             * by OnParsingStarted().
+             */
+            void MatchChild( const std::string_view aName )
+            {
+                if ( mFrames.empty() ) {
+                    return;
+                }
+
+                Frame&       lFrame    = mFrames.back();
+                const size_t lDepth    = mFrames.size() - 1;
+                const size_t lLiveEnd  = mLive.size();
+                const size_t lPosition = lFrame.IsArray
+                                         ? lFrame.NextIndex++
+                                         : 0;
+
+                for ( size_t lIndex = lFrame.LiveBegin; lIndex < lLiveEnd; ++lIndex ) {
+                    const size_t   lPointer = mLive[ lIndex ];
+                    const Pointer& lPath    = mPointers[ lPointer ];
+                    const bool     lMatches = lPath.Tokens[ lDepth ].Matches( lFrame.IsArray, lPosition, aName );
+
+                    if ( !lMatches || mValues[ lPointer ].has_value() ) {
+                        continue;
+                    }
+
+                    if ( lPath.Tokens.size() == lDepth + 1 ) {
+                        mMatches.push_back( lPointer );
+                    }
+                    else {
+                        mLive.push_back( lPointer );
+                    }
+                }
+            }
+
+            void BeginContainer( const bool             aIsArray,
+                                 const std::string_view aName,
+                                 JsonVariant&&          aEmpty )
+            {
+                if ( mSkipDepth != 0 ) {
+                    ++mSkipDepth;
+                    return;
+                }
+
+                const size_t lMatchBegin = mFrames.empty()
+                                           ? 0
+                                           : mMatches.size();
+                const size_t lLiveBegin  = mFrames.empty()
+                                           ? 0
+                                           : mLive.size();
+
+                MatchChild( aName );
+
+                if ( mCapture.empty() && ( mMatches.size() == lMatchBegin ) && ( mLive.size() == lLiveBegin ) ) {
+                    mLive.resize( lLiveBegin );
+                    mSkipDepth = 1;
+                    return;
+                }
+
+                // pointers ending here are resolved once the container is complete
+                mCaptureTargets.push_back( { mCapture.size(), {} } );
+
+                for ( size_t lIndex = lMatchBegin; lIndex < mMatches.size(); ++lIndex ) {
+                    mCaptureTargets.back().second.push_back( mMatches[ lIndex ] );
+                }
+
+                mMatches.resize( lMatchBegin );
+
+                if ( mCaptureTargets.back().second.empty() ) {
+                    mCaptureTargets.pop_back();
+                }
+
+                if ( !mCapture.empty() ) {
+                    mCapture.push_back( &Append( aName, std::move( aEmpty ) ) );
+                }
+                else if ( !mCaptureTargets.empty() ) {
+                    mCaptureRoot = std::move( aEmpty );
+                    mCapture.push_back( &mCaptureRoot );
+                }
+
+                mFrames.push_back( { aIsArray, 0, lLiveBegin } );
+            }
+
+            void EndContainer()
+            {
+                if ( mSkipDepth != 0 ) {
+                    --mSkipDepth;
+                    return;
+                }
+
+                mLive.resize( mFrames.back().LiveBegin );
+                mFrames.pop_back();
+
+                if ( mCapture.empty() ) {
+                    return;
+                }
+
+                if ( !mCaptureTargets.empty() && ( mCaptureTargets.back().first == mCapture.size() - 1 ) ) {
+                    for ( const size_t lPointer : mCaptureTargets.back().second ) {
+                        Resolve( lPointer, *mCapture.back() );
+                    }
+
+                    mCaptureTargets.pop_back();
+                }
+
+                mCapture.pop_back();
+            }
+
+            JsonVariant& Append( const std::string_view aName,
+                                 JsonVariant&&          aValue )
+            {
+                JsonVariant& lParent = *mCapture.back();
+
+                if ( lParent.IsArray() ) {
+                    std::vector<JsonVariant>& lArray = lParent.GetValueRef<std::vector<JsonVariant>>();
+                    lArray.push_back( std::move( aValue ) );
+                    return lArray.back();
+                }
+
+                JsonVariant& lItem = lParent.GetValueRef<JsonElement>()[ mKeys.Intern( aName ) ];
+                lItem = std::move( aValue );
+                return lItem;
+            }
+
+            void Resolve( const size_t       aPointer,
+                          const JsonVariant& aValue )
+            {
+                mValues[ aPointer ] = aValue;
+                --mUnresolved;
+            }
+
+        private:
+            std::vector<Pointer>                                mPointers;
+            std::vector<std::optional<JsonVariant>>             mValues;
+            std::vector<Frame>                                  mFrames;
+            std::vector<size_t>                                 mLive;
+            std::vector<size_t>                                 mMatches;
+            std::vector<JsonVariant*>                           mCapture;          /*!<containers being built, innermost last*/
+            std::vector<std::pair<size_t, std::vector<size_t>>> mCaptureTargets;   /*!<capture depth and the pointers it resolves*/
+            JsonVariant                                         mCaptureRoot;
+            KeyTable                                            mKeys;
+            size_t                                              mSkipDepth  = 0;
+            size_t                                              mUnresolved = 0;
+        };
+
+    private:
+        Handler                  mHandler;
+        BasicJsonParser<Handler> mParser;
+    };
+}
@@ -0,0 +1,529 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+namespace jsbjson
+{
+    /*!
+     * Sequence kept in chunks that double in size, chunk k holds
+     * kFirstChunkSize << k elements. Adding an element never moves the
+     * others, so references and iterators stay valid until the element they
+     * refer to is erased. Erasing moves the elements behind it down by one.
+     * The first chunk pointer is kept inline, so a sequence that fits in it
+     * costs a single allocation.
+     */
+    template<typename T,
+             typename ALLOCATOR = std::allocator<T>>
+    class SegmentedVector
+    {
+    private:
+        using Traits = typename std::allocator_traits<ALLOCATOR>::template rebind_traits<T>;
+
+    public:
+        using value_type      = T;
+        using allocator_type  = typename Traits::allocator_type;
+        using size_type       = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = T&;
+        using const_reference = const T&;
+
+        static constexpr size_t kFirstChunkSize = 4;
+
+        /*!
+         * Position in a sequence, it stays on the same position while
+         * elements are added.
+         */
+        template<bool CONST>
+        class Iterator final
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = std::conditional_t<CONST, const T*, T*>;
+            using reference         = std::conditional_t<CONST, const T&, T&>;
+            using Owner             = std::conditional_t<CONST, const SegmentedVector, SegmentedVector>;
+
+            Iterator() = default;
+
+            Iterator( Owner*       aOwner,
+                      const size_t aPosition )
+                : mOwner( aOwner )
+                , mPosition( aPosition )
+            {}
+
+            template<bool OTHER, typename = std::enable_if_t<CONST && !OTHER>>
+            Iterator( const Iterator<OTHER>& aOther )
+                : mOwner( aOther.mOwner )
+                , mPosition( aOther.mPosition )
+            {}
+
+            size_t Position() const
+            {
+                return mPosition;
+            }
+
+            reference operator *() const
+            {
+                return ( *mOwner )[ mPosition ];
+            }
+
+            pointer operator ->() const
+            {
+                return &( *mOwner )[ mPosition ];
+            }
+
+            reference operator []( const difference_type aOffset ) const
+            {
+                return ( *mOwner )[ mPosition + aOffset ];
+            }
+
+            Iterator& operator ++()
+            {
+                ++mPosition;
+                return *this;
+            }
+
+            Iterator operator ++( int )
+            {
+                Iterator lPrevious = *this;
+                ++mPosition;
+                return lPrevious;
+            }
+
+            Iterator& operator --()
+            {
+                --mPosition;
+                return *this;
+            }
+
+            Iterator operator --( int )
+            {
+                Iterator lPrevious = *this;
+                --mPosition;
+                return lPrevious;
+            }
+
+            Iterator& operator +=( const difference_type aOffset )
+            {
+                mPosition += aOffset;
+                return *this;
+            }
+
+            Iterator& operator -=( const difference_type aOffset )
+            {
+                mPosition -= aOffset;
+                return *this;
+            }
+
+            Iterator operator +( const difference_type aOffset ) const
+            {
+                return Iterator( mOwner, mPosition + aOffset );
+            }
+
+            friend Iterator operator +( const difference_type aOffset,
+                                        const Iterator&       aIterator )
+            {
+                return aIterator + aOffset;
+            }
+
+            Iterator operator -( const difference_type aOffset ) const
+            {
+                return Iterator( mOwner, mPosition - aOffset );
+            }
+
+            template<bool OTHER>
+            difference_type operator -( const Iterator<OTHER>& aOther ) const
+            {
+                return static_cast<difference_type>( mPosition ) - static_cast<difference_type>( aOther.mPosition );
+            }
+
+            template<bool OTHER>
+            bool operator ==( const Iterator<OTHER>& aOther ) const
+            {
+                return mPosition == aOther.mPosition;
+            }
+
+            template<bool OTHER>
+            bool operator !=( const Iterator<OTHER>& aOther ) const
+            {
+                return mPosition != aOther.mPosition;
+            }
+
+            template<bool OTHER>
+            bool operator <( const Iterator<OTHER>& aOther ) const
+            {
+                return mPosition < aOther.mPosition;
+            }
+
+            template<bool OTHER>
+            bool operator >( const Iterator<OTHER>& aOther ) const
+            {
+                return mPosition > aOther.mPosition;
+            }
+
+            template<bool OTHER>
+            bool operator <=( const Iterator<OTHER>& aOther ) const
+            {
+                return mPosition <= aOther.mPosition;
+            }
+
+            template<bool OTHER>
+            bool operator >=( const Iterator<OTHER>& aOther ) const
+            {
+                return mPosition >= aOther.mPosition;
+            }
+
+        private:
+            template<bool>
+            friend class Iterator;
+
+            Owner* mOwner    = nullptr;
+            size_t mPosition = 0;
+        };
+
+        using iterator       = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        SegmentedVector()
+            : SegmentedVector( allocator_type {} )
+        {}
+
+        explicit SegmentedVector( const allocator_type& aAllocator )
+            : mAllocator( aAllocator )
+            , mChunks( ChunkAllocator( aAllocator ) )
+        {}
+
+        SegmentedVector( const SegmentedVector& aOther )
+            : SegmentedVector( Traits::select_on_container_copy_construction( aOther.mAllocator ) )
+        {
+            try {
+                Append( aOther );
+            }
+            catch ( ... ) {
+                Release();
+                throw;
+            }
+        }
+
+        SegmentedVector( SegmentedVector&& aOther ) noexcept
+            : mAllocator( std::move( aOther.mAllocator ) )
+            , mFirst( aOther.mFirst )
+            , mChunks( std::move( aOther.mChunks ) )
+            , mSize( aOther.mSize )
+        {
+            aOther.Forget();
+        }
+
+        SegmentedVector& operator=( const SegmentedVector& aOther )
+        {
+            if ( this == &aOther ) {
+                return *this;
+            }
+
+            clear();
+
+            if constexpr ( Traits::propagate_on_container_copy_assignment::value ) {
+                if ( mAllocator != aOther.mAllocator ) {
+                    Release();
+                }
+
+                mAllocator = aOther.mAllocator;
+            }
+
+            Append( aOther );
+            return *this;
+        }
+
+        /*!
+         * Takes the chunks over when the allocator propagates or both
+         * allocators are equal, otherwise moves the elements one by one.
+         */
+        SegmentedVector& operator=( SegmentedVector&& aOther )
+        {
+            if ( this == &aOther ) {
+                return *this;
+            }
+
+            if constexpr ( !Traits::propagate_on_container_move_assignment::value ) {
+                if ( mAllocator != aOther.mAllocator ) {
+                    clear();
+                    reserve( aOther.size() );
+
+                    for ( T& lElement : aOther ) {
+                        emplace_back( std::move( lElement ) );
+                    }
+
+                    aOther.clear();
+                    return *this;
+                }
+            }
+
+            Release();
+
+            if constexpr ( Traits::propagate_on_container_move_assignment::value ) {
+                mAllocator = std::move( aOther.mAllocator );
+            }
+
+            mFirst  = aOther.mFirst;
+            mChunks = std::move( aOther.mChunks );
+            mSize   = aOther.mSize;
+            aOther.Forget();
+            return *this;
+        }
+
+        ~SegmentedVector()
+        {
+            Release();
+        }
+
+        iterator begin()
+        {
+            return iterator( this, 0 );
+        }
+
+        iterator end()
+        {
+            return iterator( this, mSize );
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator( this, 0 );
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator( this, mSize );
+        }
+
+        const_iterator cbegin() const
+        {
+            return begin();
+        }
+
+        const_iterator cend() const
+        {
+            return end();
+        }
+
+        size_t size() const
+        {
+            return mSize;
+        }
+
+        bool empty() const
+        {
+            return mSize == 0;
+        }
+
+        allocator_type get_allocator() const
+        {
+            return mAllocator;
+        }
+
+        T& operator []( const size_t aPosition )
+        {
+            size_t lOffset = 0;
+            return Chunk( Locate( aPosition, lOffset ) )[ lOffset ];
+        }
+
+        const T& operator []( const size_t aPosition ) const
+        {
+            size_t lOffset = 0;
+            return Chunk( Locate( aPosition, lOffset ) )[ lOffset ];
+        }
+
+        T& back()
+        {
+            return ( *this )[ mSize - 1 ];
+        }
+
+        const T& back() const
+        {
+            return ( *this )[ mSize - 1 ];
+        }
+
+        /*!
+         * Allocates chunks until aCount elements fit.
+         */
+        void reserve( const size_t aCount )
+        {
+            while ( Capacity() < aCount ) {
+                AddChunk();
+            }
+        }
+
+        template<typename... ARGS>
+        T& emplace_back( ARGS&&... aArgs )
+        {
+            size_t       lOffset = 0;
+            const size_t lChunk  = Locate( mSize, lOffset );
+
+            if ( lChunk == ChunkCount() ) {
+                AddChunk();
+            }
+
+            T* lElement = Chunk( lChunk ) + lOffset;
+            Traits::construct( mAllocator, lElement, std::forward<ARGS>( aArgs )... );
+            ++mSize;
+            return *lElement;
+        }
+
+        iterator erase( const const_iterator aPosition )
+        {
+            const size_t lPosition = aPosition.Position();
+
+            for ( size_t lIndex = lPosition; lIndex + 1 < mSize; ++lIndex ) {
+                ( *this )[ lIndex ] = std::move( ( *this )[ lIndex + 1 ] );
+            }
+
+            Traits::destroy( mAllocator, &back() );
+            --mSize;
+            return iterator( this, lPosition );
+        }
+
+        /*!
+         * Destroys the elements and keeps the chunks.
+         */
+        void clear()
+        {
+            for ( size_t lChunk = 0, lDone = 0; lDone < mSize; ++lChunk ) {
+                T*           lElements = Chunk( lChunk );
+                const size_t lCount    = std::min( ChunkSize( lChunk ), mSize - lDone );
+
+                for ( size_t lIndex = 0; lIndex < lCount; ++lIndex ) {
+                    Traits::destroy( mAllocator, lElements + lIndex );
+                }
+
+                lDone += lCount;
+            }
+
+            mSize = 0;
+        }
+
+        void swap( SegmentedVector& aOther )
+        {
+            if constexpr ( Traits::propagate_on_container_swap::value ) {
+                std::swap( mAllocator, aOther.mAllocator );
+            }
+
+            std::swap( mFirst, aOther.mFirst );
+            mChunks.swap( aOther.mChunks );
+            std::swap( mSize, aOther.mSize );
+        }
+
+    private:
+        using ChunkAllocator = typename Traits::template rebind_alloc<T*>;
+
+        static size_t ChunkSize( const size_t aChunk )
+        {
+            return kFirstChunkSize << aChunk;
+        }
+
+        /*!
+         * Chunk holding aPosition and the offset of aPosition in it.
+         */
+        static size_t Locate( const size_t aPosition,
+                              size_t&      aOffset )
+        {
+            const uint64_t lBlock = aPosition / kFirstChunkSize + 1;
+#if defined( _MSC_VER )
+            unsigned long lChunk = 0;
+            _BitScanReverse64( &lChunk, lBlock );
+#else
+            const size_t lChunk = 63 - __builtin_clzll( lBlock );
+#endif
+            aOffset = aPosition - kFirstChunkSize * ( ( size_t( 1 ) << lChunk ) - 1 );
+            return lChunk;
+        }
+
+        T* Chunk( const size_t aChunk ) const
+        {
+            return aChunk == 0
+                   ? mFirst
+                   : mChunks[ aChunk - 1 ];
+        }
+
+        size_t ChunkCount() const
+        {
+            return mFirst == nullptr
+                   ? 0
+                   : mChunks.size() + 1;
+        }
+
+        size_t Capacity() const
+        {
+            return kFirstChunkSize * ( ( size_t( 1 ) << ChunkCount() ) - 1 );
+        }
+
+        void AddChunk()
+        {
+            const size_t lChunk    = ChunkCount();
+            T*           lElements = Traits::allocate( mAllocator, ChunkSize( lChunk ) );
+
+            if ( lChunk == 0 ) {
+                mFirst = lElements;
+                return;
+            }
+
+            try {
+                mChunks.push_back( lElements );
+            }
+            catch ( ... ) {
+                Traits::deallocate( mAllocator, lElements, ChunkSize( lChunk ) );
+                throw;
+            }
+        }
+
+        void Append( const SegmentedVector& aOther )
+        {
+            reserve( mSize + aOther.size() );
+
+            for ( const T& lElement : aOther ) {
+                emplace_back( lElement );
+            }
+        }
+
+        /*!
+         * Destroys the elements and frees the chunks.
+         */
+        void Release()
+        {
+            clear();
+
+            for ( size_t lChunk = ChunkCount(); lChunk > 0; --lChunk ) {
+                Traits::deallocate( mAllocator, Chunk( lChunk - 1 ), ChunkSize( lChunk - 1 ) );
+            }
+
+            Forget();
+        }
+
+        /*!
+         * Drops the chunks without freeing them, after they were handed over.
+         */
+        void Forget()
+        {
+            mFirst = nullptr;
+            mChunks.clear();
+            mSize = 0;
+        }
+
+    private:
+        allocator_type                      mAllocator;
+        T*                                  mFirst = nullptr;   /*!<chunk 0*/
+        std::vector<T*, ChunkAllocator>     mChunks;            /*!<chunks 1 and up*/
+        size_t                              mSize  = 0;
+    };
+}
@@ -0,0 +1,446 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define JSBJSON_X64 1
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+#endif
+
+#if defined( JSBJSON_X64 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define JSBJSON_TARGET( aTarget ) __attribute__( ( target( aTarget ) ) )
+#else
+#define JSBJSON_TARGET( aTarget )
+#endif
+
+namespace jsbjson
+{
+    namespace simd
+    {
+        constexpr size_t kBlockSize = 64;
+
+        struct BlockMasks final
+        {
+            uint64_t Quote      = 0;
+            uint64_t Backslash  = 0;
+            uint64_t Structural = 0;
+            uint64_t Control    = 0;   /*!<bytes below 0x20*/
+        };
+
+        using ClassifyFunction = BlockMasks ( * )( const char* aBlock );
+
+        inline BlockMasks ClassifyScalar( const char* aBlock )
+        {
+            BlockMasks lMasks;
+
+            for ( size_t lIndex = 0; lIndex < kBlockSize; ++lIndex ) {
+                const uint64_t lBit = uint64_t { 1 } << lIndex;
+
+                if ( static_cast<unsigned char>( aBlock[ lIndex ] ) < 0x20 ) {
+                    lMasks.Control |= lBit;
+                }
+
+                switch ( aBlock[ lIndex ] ) {
+                case '\"':
+                    lMasks.Quote |= lBit;
+                    break;
+
+                case '\\':
+                    lMasks.Backslash |= lBit;
+                    break;
+
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    lMasks.Structural |= lBit;
+                    break;
+
+                default:
+                    break;
+                }
+            }
+
+            return lMasks;
+        }
+
+#if defined( JSBJSON_X64 )
+        JSBJSON_TARGET( "sse4.2" )
+        inline uint64_t MatchSse42( const __m128i aChunks[ 4 ],
+                                    const char    aChar )
+        {
+            const __m128i lNeedle = _mm_set1_epi8( aChar );
+            uint64_t      lResult = 0;
+
+            for ( size_t lIndex = 0; lIndex < 4; ++lIndex ) {
+                const uint64_t lMask = static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( aChunks[ lIndex ], lNeedle ) ) );
+                lResult |= lMask << ( lIndex * 16 );
+            }
+
+            return lResult;
+        }
+
+        JSBJSON_TARGET( "sse4.2" )
+        inline uint64_t MatchControlSse42( const __m128i aChunks[ 4 ] )
+        {
+            const __m128i lLimit  = _mm_set1_epi8( 0x1F );
+            uint64_t      lResult = 0;
+
+            for ( size_t lIndex = 0; lIndex < 4; ++lIndex ) {
+                const __m128i  lBelow = _mm_cmpeq_epi8( _mm_max_epu8( aChunks[ lIndex ], lLimit ), lLimit );
+                const uint64_t lMask  = static_cast<uint32_t>( _mm_movemask_epi8( lBelow ) );
+                lResult |= lMask << ( lIndex * 16 );
+            }
+
+            return lResult;
+        }
+
+        JSBJSON_TARGET( "sse4.2" )
+        inline BlockMasks ClassifySse42( const char* aBlock )
+        {
+            const __m128i lChunks[ 4 ] = {
+                _mm_loadu_si128( reinterpret_cast<const __m128i*>( aBlock ) ),
+                _mm_loadu_si128( reinterpret_cast<const __m128i*>( aBlock + 16 ) ),
+                _mm_loadu_si128( reinterpret_cast<const __m128i*>( aBlock + 32 ) ),
+                _mm_loadu_si128( reinterpret_cast<const __m128i*>( aBlock + 48 ) )
+            };
+
+            BlockMasks lMasks;
+            lMasks.Quote      = MatchSse42( lChunks, '\"' );
+            lMasks.Backslash  = MatchSse42( lChunks, '\\' );
+            lMasks.Structural = MatchSse42( lChunks, '{' )
+                                | MatchSse42( lChunks, '}' )
+                                | MatchSse42( lChunks, '[' )
+                                | MatchSse42( lChunks, ']' )
+                                | MatchSse42( lChunks, ':' )
+                                | MatchSse42( lChunks, ',' );
+            lMasks.Control    = MatchControlSse42( lChunks );
+            return lMasks;
+        }
+
+        JSBJSON_TARGET( "avx2" )
+        inline uint64_t MatchAvx2( const __m256i aLow,
+                                   const __m256i aHigh,
+                                   const char    aChar )
+        {
+            const __m256i  lNeedle = _mm256_set1_epi8( aChar );
+            const uint64_t lLow    = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( aLow, lNeedle ) ) );
+            const uint64_t lHigh   = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( aHigh, lNeedle ) ) );
+            return lLow | ( lHigh << 32 );
+        }
+
+        JSBJSON_TARGET( "avx2" )
+        inline uint64_t MatchControlAvx2( const __m256i aLow,
+                                          const __m256i aHigh )
+        {
+            const __m256i  lLimit = _mm256_set1_epi8( 0x1F );
+            const uint64_t lLow   = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_max_epu8( aLow, lLimit ), lLimit ) ) );
+            const uint64_t lHigh  = static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_max_epu8( aHigh, lLimit ), lLimit ) ) );
+            return lLow | ( lHigh << 32 );
+        }
+
+        JSBJSON_TARGET( "avx2" )
+        inline BlockMasks ClassifyAvx2( const char* aBlock )
+        {
+            const __m256i lLow  = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( aBlock ) );
+            const __m256i lHigh = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( aBlock + 32 ) );
+
+            BlockMasks lMasks;
+            lMasks.Quote      = MatchAvx2( lLow, lHigh, '\"' );
+            lMasks.Backslash  = MatchAvx2( lLow, lHigh, '\\' );
+            lMasks.Structural = MatchAvx2( lLow, lHigh, '{' )
+                                | MatchAvx2( lLow, lHigh, '}' )
+                                | MatchAvx2( lLow, lHigh, '[' )
+                                | MatchAvx2( lLow, lHigh, ']' )
+                                | MatchAvx2( lLow, lHigh, ':' )
+                                | MatchAvx2( lLow, lHigh, ',' );
+            lMasks.Control    = MatchControlAvx2( lLow, lHigh );
+            return lMasks;
+        }
+
+#if defined( _MSC_VER )
+        inline bool CpuSupports( const int aLeaf,
+                                 const int aRegister,
+                                 const int aBit )
+        {
+            int lRegisters[ 4 ] = {};
+            __cpuidex( lRegisters, aLeaf, 0 );
+            return ( lRegisters[ aRegister ] & ( 1 << aBit ) ) != 0;
+        }
+#endif
+#endif
+
+        inline ClassifyFunction SelectClassifier()
+        {
+#if defined( JSBJSON_X64 )
+#if defined( __GNUC__ ) || defined( __clang__ )
+            __builtin_cpu_init();
+
+            if ( __builtin_cpu_supports( "avx2" ) ) {
+                return &ClassifyAvx2;
+            }
+
+            if ( __builtin_cpu_supports( "sse4.2" ) ) {
+                return &ClassifySse42;
+            }
+#else
+            // AVX2 also needs OS support for the ymm state (OSXSAVE + XCR0)
+            if ( CpuSupports( 7, 1, 5 )
+                 && CpuSupports( 1, 2, 27 )
+                 && ( ( _xgetbv( 0 ) & 0x6 ) == 0x6 ) )
+            {
+                return &ClassifyAvx2;
+            }
+
+            if ( CpuSupports( 1, 2, 20 ) ) {
+                return &ClassifySse42;
+            }
+#endif
+#endif
+            return &ClassifyScalar;
+        }
+
+        inline ClassifyFunction Classifier()
+        {
+            static const ClassifyFunction kClassifier = SelectClassifier();
+            return kClassifier;
+        }
+
+        inline uint64_t PrefixXor( uint64_t aMask )
+        {
+            aMask ^= aMask << 1;
+            aMask ^= aMask << 2;
+            aMask ^= aMask << 4;
+            aMask ^= aMask << 8;
+            aMask ^= aMask << 16;
+            aMask ^= aMask << 32;
+            return aMask;
+        }
+
+        inline uint32_t CountTrailingZeros( const uint64_t aMask )
+        {
+#if defined( _MSC_VER )
+            unsigned long lIndex = 0;
+            _BitScanForward64( &lIndex, aMask );
+            return static_cast<uint32_t>( lIndex );
+#else
+            return static_cast<uint32_t>( __builtin_ctzll( aMask ) );
+#endif
+        }
+
+        /*!
+         * Returns the characters escaped by a backslash run. aPreviousEscaped carries
+         * the escape state of the last character over to the next block.
+         */
+        inline uint64_t FindEscaped( uint64_t  aBackslash,
+                                     uint64_t& aPreviousEscaped )
+        {
+            constexpr uint64_t kEvenBits = 0x5555555555555555ULL;
+
+            aBackslash &= ~aPreviousEscaped;
+            const uint64_t lFollowsEscape = ( aBackslash << 1 ) | aPreviousEscaped;
+            const uint64_t lOddStarts     = aBackslash & ~kEvenBits & ~lFollowsEscape;
+            const uint64_t lEvenSequences = lOddStarts + aBackslash;
+
+            aPreviousEscaped = lEvenSequences < lOddStarts
+                               ? 1
+                               : 0;
+
+            const uint64_t lInvertMask = lEvenSequences << 1;
+            return ( kEvenBits ^ lInvertMask ) & lFollowsEscape;
+        }
+    }
+
+    class StructuralIndex
+    {
+    public:
+        /*!
+         * Positions are 32 bits, larger documents cannot be indexed.
+         */
+        static constexpr size_t kMaxDocumentSize = std::numeric_limits<uint32_t>::max();
+
+        bool Build( const std::string_view aJsonDocument )
+        {
+            mPositions.clear();
+            mComplete        = false;
+            mHasBackslash    = false;
+            mControlInString = std::string_view::npos;
+            mSize            = 0;
+
+            if ( aJsonDocument.size() > kMaxDocumentSize ) {
+                return false;
+            }
+
+            mSize = aJsonDocument.size();
+
+            mPositions.reserve( aJsonDocument.size() / 4 + 16 );
+
+            const simd::ClassifyFunction lClassify        = simd::Classifier();
+            const char*                  lData            = aJsonDocument.data();
+            const size_t                 lSize            = aJsonDocument.size();
+            uint64_t                     lPreviousEscaped = 0;
+            uint64_t                     lInString        = 0;
+            size_t                       lOffset          = 0;
+
+            for ( ; lOffset + simd::kBlockSize <= lSize; lOffset += simd::kBlockSize ) {
+                IndexBlock( lClassify( lData + lOffset ), lOffset, lPreviousEscaped, lInString );
+            }
+
+            if ( lOffset < lSize ) {
+                char lTail[ simd::kBlockSize ];
+                std::memset( lTail, ' ', simd::kBlockSize );
+                std::memcpy( lTail, lData + lOffset, lSize - lOffset );
+                IndexBlock( lClassify( lTail ), lOffset, lPreviousEscaped, lInString );
+            }
+
+            mComplete = lInString == 0;
+            return mComplete;
+        }
+
+        const std::vector<uint32_t>& Positions() const
+        {
+            return mPositions;
+        }
+
+        bool IsComplete() const
+        {
+            return mComplete;
+        }
+
+        /*!
+         * Whether the index may belong to aJsonDocument, it was built for a
+         * document of the same size, so every position lies inside it.
+         */
+        bool IsFor( const std::string_view aJsonDocument ) const
+        {
+            return ( mSize == aJsonDocument.size() )
+                   && ( mPositions.empty() || ( mPositions.back() < aJsonDocument.size() ) );
+        }
+
+        /*!
+         * Offset of the first raw control character inside a string, which JSON
+         * does not allow, or npos.
+         */
+        size_t ControlInString() const
+        {
+            return mControlInString;
+        }
+
+        bool HasBackslash() const
+        {
+            return mHasBackslash;
+        }
+
+    private:
+        void IndexBlock( const simd::BlockMasks& aMasks,
+                         const size_t            aOffset,
+                         uint64_t&               aPreviousEscaped,
+                         uint64_t&               aInString )
+        {
+            const uint64_t lEscaped  = simd::FindEscaped( aMasks.Backslash, aPreviousEscaped );
+            const uint64_t lQuotes   = aMasks.Quote & ~lEscaped;
+            const uint64_t lInString = simd::PrefixXor( lQuotes ) ^ aInString;
+
+            aInString = static_cast<uint64_t>( static_cast<int64_t>( lInString ) >> 63 );
+
+            const uint64_t lControl = aMasks.Control & lInString;
+
+            if ( ( lControl != 0 ) && ( mControlInString == std::string_view::npos ) ) {
+                mControlInString = aOffset + simd::CountTrailingZeros( lControl );
+            }
+
+            mHasBackslash = mHasBackslash || ( aMasks.Backslash != 0 );
+
+            uint64_t lStructurals = ( aMasks.Structural & ~lInString ) | lQuotes;
+
+            while ( lStructurals != 0 ) {
+                mPositions.push_back( static_cast<uint32_t>( aOffset + simd::CountTrailingZeros( lStructurals ) ) );
+                lStructurals &= lStructurals - 1;
+            }
+        }
+
+    private:
+        std::vector<uint32_t> mPositions;
+        bool                  mComplete        = false;
+        bool                  mHasBackslash    = false;
+        size_t                mControlInString = std::string_view::npos;
+        size_t                mSize            = 0;   /*!<size of the indexed document*/
+    };
+
+    /*!
+     * Walks the positions of a StructuralIndex. After is the first offset of
+     * the document not consumed yet, the text between After and the current
+     * position holds literals and whitespace.
+     */
+    struct StructuralCursor final
+    {
+        static bool IsWhitespace( const char aChar )
+        {
+            return ( aChar == ' ' )
+                   || ( aChar == '\n' )
+                   || ( aChar == '\r' )
+                   || ( aChar == '\t' );
+        }
+
+        const std::string_view       Document;
+        const std::vector<uint32_t>& Positions;
+        size_t                       Index = 0;
+        size_t                       After = 0;
+
+        bool AtEnd() const
+        {
+            return Index >= Positions.size();
+        }
+
+        char Peek() const
+        {
+            return Document[ Positions[ Index ] ];
+        }
+
+        size_t Offset() const
+        {
+            return Positions[ Index ];
+        }
+
+        void Advance()
+        {
+            After = Positions[ Index ] + 1;
+            ++Index;
+        }
+
+        bool IsBlankUntil( const size_t aEnd ) const
+        {
+            for ( size_t lOffset = After; lOffset < aEnd; ++lOffset ) {
+                if ( !IsWhitespace( Document[ lOffset ] ) ) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        std::string_view Span( size_t aBegin,
+                               size_t aEnd ) const
+        {
+            while ( ( aBegin < aEnd ) && IsWhitespace( Document[ aBegin ] ) ) {
+                ++aBegin;
+            }
+
+            while ( ( aEnd > aBegin ) && IsWhitespace( Document[ aEnd - 1 ] ) ) {
+                --aEnd;
+            }
+
+            return Document.substr( aBegin, aEnd - aBegin );
+        }
+    };
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace jsbjson
+{
+    /*!
+     * Fixed size pool of workers, each with its own task deque. A worker pops
+     * from the back of its own deque and steals from the front of the others
+     * when it runs dry.
+     */
+    class ThreadPool final
+    {
+    public:
+        explicit ThreadPool( const size_t aThreadCount = std::thread::hardware_concurrency() )
+        {
+            const size_t lThreadCount = std::max<size_t>( aThreadCount, 1 );
+
+            for ( size_t lIndex = 0; lIndex < lThreadCount; ++lIndex ) {
+                mWorkers.push_back( std::make_unique<Worker>() );
+            }
+
+            for ( size_t lIndex = 0; lIndex < lThreadCount; ++lIndex ) {
+                mThreads.emplace_back( [ this, lIndex ] ()
+                                       {
+                                           WorkerLoop( lIndex );
+                                       } );
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lLock( mWakeMutex );
+                mStop = true;
+            }
+
+            mWake.notify_all();
+
+            for ( auto& lThread : mThreads ) {
+                lThread.join();
+            }
+        }
+
+        ThreadPool( const ThreadPool& )            = delete;
+        ThreadPool& operator=( const ThreadPool& ) = delete;
+
+        size_t Size() const
+        {
+            return mWorkers.size();
+        }
+
+        /*!
+         * Calls aFunction( aIndex ) for every index in [0, aCount) on the pool and
+         * returns once all of them finished. The calling thread helps out. If
+         * calls throw, the first exception is rethrown once all calls are done.
+         */
+        template<typename FUNCTION>
+        void ParallelFor( const size_t aCount,
+                          FUNCTION&&   aFunction )
+        {
+            if ( aCount == 0 ) {
+                return;
+            }
+
+            struct Completion final
+            {
+                std::mutex              Mutex;
+                std::condition_variable Done;
+                size_t                  Remaining = 0;
+                std::exception_ptr      Error;   /*!<first exception thrown by a call*/
+
+                void Finish( const size_t       aCount,
+                             std::exception_ptr aError )
+                {
+                    std::lock_guard<std::mutex> lLock( Mutex );
+
+                    if ( aError && !Error ) {
+                        Error = std::move( aError );
+                    }
+
+                    Remaining -= aCount;
+
+                    if ( Remaining == 0 ) {
+                        Done.notify_all();
+                    }
+                }
+            };
+
+            Completion lCompletion;
+            lCompletion.Remaining = aCount;
+
+            size_t lPushed = 0;
+
+            try {
+                for ( ; lPushed < aCount; ++lPushed ) {
+                    Push( lPushed % mWorkers.size(), [ &aFunction, &lCompletion, lIndex = lPushed ] ()
+                          {
+                              std::exception_ptr lError;
+
+                              try {
+                                  aFunction( lIndex );
+                              }
+                              catch ( ... ) {
+                                  lError = std::current_exception();
+                              }
+
+                              lCompletion.Finish( 1, std::move( lError ) );
+                          } );
+                }
+            }
+            catch ( ... ) {
+                // the tasks already queued still refer to lCompletion
+                lCompletion.Finish( aCount - lPushed, std::current_exception() );
+            }
+
+            std::function<void()> lTask;
+
+            while ( TryPop( 0, lTask ) ) {
+                lTask();
+            }
+
+            std::unique_lock<std::mutex> lLock( lCompletion.Mutex );
+            lCompletion.Done.wait( lLock, [ &lCompletion ] ()
+                                   {
+                                       return lCompletion.Remaining == 0;
+                                   } );
+
+            if ( lCompletion.Error ) {
+                std::rethrow_exception( lCompletion.Error );
+            }
+        }
+
+    private:
+        struct Worker final
+        {
+            std::mutex                        Mutex;
+            std::deque<std::function<void()>> Tasks;
+        };
+
+        void Push( const size_t            aWorker,
+                   std::function<void()>&& aTask )
+        {
+            {
+                std::lock_guard<std::mutex> lLock( mWakeMutex );
+                ++mQueued;
+            }
+
+            {
+                std::lock_guard<std::mutex> lLock( mWorkers[ aWorker ]->Mutex );
+                mWorkers[ aWorker ]->Tasks.push_back( std::move( aTask ) );
+            }
+
+            mWake.notify_one();
+        }
+
+        bool TryPop( const size_t           aWorker,
+                     std::function<void()>& aTask )
+        {
+            {
+                Worker&                     lOwn = *mWorkers[ aWorker ];
+                std::lock_guard<std::mutex> lLock( lOwn.Mutex );
+
+                if ( !lOwn.Tasks.empty() ) {
+                    aTask = std::move( lOwn.Tasks.back() );
+                    lOwn.Tasks.pop_back();
+                    --mQueued;
+                    return true;
+                }
+            }
+
+            for ( size_t lOffset = 1; lOffset < mWorkers.size(); ++lOffset ) {
+                Worker&                     lVictim = *mWorkers[ ( aWorker + lOffset ) % mWorkers.size() ];
+                std::lock_guard<std::mutex> lLock( lVictim.Mutex );
+
+                if ( !lVictim.Tasks.empty() ) {
+                    aTask = std::move( lVictim.Tasks.front() );
+                    lVictim.Tasks.pop_front();
+                    --mQueued;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void WorkerLoop( const size_t aIndex )
+        {
+            std::function<void()> lTask;
+
+            while ( true ) {
+                if ( TryPop( aIndex, lTask ) ) {
+                    lTask();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lLock( mWakeMutex );
+                mWake.wait( lLock, [ this ] ()
+                            {
+                                return mStop || ( mQueued > 0 );
+                            } );
+
+                if ( mStop ) {
+                    return;
+                }
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+        std::vector<std::thread>             mThreads;
+        std::mutex                           mWakeMutex;
+        std::condition_variable              mWake;
+        std::atomic<size_t>                  mQueued { 0 };
+        bool                                 mStop = false;
+    };
+}
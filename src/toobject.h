@@ -2,8 +2,12 @@
 #include <optional>
 #include <vector>
 #include "parser.h"
+#include "structuralindex.h"
+#include "mappedfile.h"
 #include "typehelpers.h"
 #include "mapparsernotifier.h"
+#include "ondemandbinder.h"
+#include "jsontape.h"
 
 namespace jsbjson
 {
@@ -60,7 +64,7 @@ namespace jsbjson
         void ProcessObject( OBJECT&&           aObject,
                             const JsonElement& aJsonObject )
         {
-            const auto& lItemIt = aJsonObject.find( aObject.Name() );
+            const auto& lItemIt = aJsonObject.find( KeyOf( aObject ) );
 
             if ( lItemIt == aJsonObject.cend() ) {
                 return;
@@ -97,7 +101,7 @@ namespace jsbjson
                 using MemberT = std::decay_t<MEMBER>::Type;
 
                 if constexpr ( IsArray<MemberT>::value ) {
-                    const auto& lItemIt = aJsonObject.find( aMember.Name() );
+                    const auto& lItemIt = aJsonObject.find( KeyOf( aMember ) );
 
                     if ( lItemIt == aJsonObject.cend() ) {
                         return;
@@ -115,7 +119,7 @@ namespace jsbjson
                     }
                 }
                 else {
-                    const auto& lItemIt = aJsonObject.find( aMember.Name() );
+                    const auto& lItemIt = aJsonObject.find( KeyOf( aMember ) );
 
                     if ( lItemIt == aJsonObject.cend() ) {
                         return;
@@ -130,17 +134,159 @@ namespace jsbjson
             }
         }
 
+        template<typename MEMBERTYPE>
+        MEMBERTYPE ExtractArray( const TapeArray& aSourceArray )
+        {
+            if constexpr ( IsArray<MEMBERTYPE>::value ) {
+                using ArrayItemType = typename MEMBERTYPE::value_type;
+                MEMBERTYPE lResult;
+
+                for ( const TapeValue lItem : aSourceArray ) {
+                    if ( lItem.IsArray() ) {
+                        if constexpr ( IsArray<ArrayItemType>::value ) {
+                            lResult.push_back( ExtractArray<ArrayItemType>( lItem.GetValue<TapeArray>().value() ) );
+                        }
+
+                        continue;
+                    }
+
+                    if ( lItem.IsObject() ) {
+                        if constexpr ( HasConvertRef<ArrayItemType>::value ) {
+                            ArrayItemType lArrayItem;
+                            BindTape( lArrayItem, lItem.GetValue<TapeObject>().value() );
+                            lResult.push_back( lArrayItem );
+                        }
+
+                        continue;
+                    }
+
+                    const std::optional<ArrayItemType> lValueOpt = lItem.GetValue<ArrayItemType>();
+
+                    if ( lValueOpt.has_value() ) {
+                        lResult.push_back( lValueOpt.value() );
+                    }
+                }
+
+                return lResult;
+            }
+        }
+
+        template<typename TARGET>
+        void BindTape( TARGET&           aTarget,
+                       const TapeObject& aJsonObject )
+        {
+            auto lValuesAsTuple = aTarget.ConvertRef();
+            std::apply( [ & ] (auto&... aArgs)
+                        {
+                            ( Process<decltype( aArgs )>( std::forward<decltype( aArgs )>( aArgs ), aJsonObject ), ... );
+                        }, lValuesAsTuple );
+        }
+
+        template<typename MEMBER>
+        void Process( MEMBER&&          aMember,
+                      const TapeObject& aJsonObject )
+        {
+            const TapeValue lItem = aJsonObject.Find( KeyOf( aMember ).Str() );
+
+            if constexpr ( IsObject<std::decay_t<MEMBER>>::value ) {
+                if ( lItem.IsObject() ) {
+                    BindTape( aMember, lItem.GetValue<TapeObject>().value() );
+                }
+            }
+
+            if constexpr ( IsMember<std::decay_t<MEMBER>>::value ) {
+                using MemberT = typename std::decay_t<MEMBER>::Type;
+
+                if constexpr ( IsArray<MemberT>::value ) {
+                    if ( lItem.IsArray() ) {
+                        aMember = ExtractArray<MemberT>( lItem.GetValue<TapeArray>().value() );
+                    }
+                }
+                else {
+                    const std::optional<MemberT> lValue = lItem.GetValue<MemberT>();
+
+                    if ( lValue.has_value() ) {
+                        aMember = lValue.value();
+                    }
+                }
+            }
+        }
+
     public:
-        std::optional<std::decay_t<OBJECT>> operator ()( const std::string& aJsonDocument )
+        std::optional<std::decay_t<OBJECT>> operator ()( const char*  aData,
+                                                         const size_t aSize )
+        {
+            return ( *this )( std::string_view( aData, aSize ) );
+        }
+
+        std::optional<std::decay_t<OBJECT>> operator ()( const std::string_view aJsonDocument )
+        {
+            StructuralIndex lIndex;
+            lIndex.Build( aJsonDocument );
+            return ( *this )( aJsonDocument, lIndex );
+        }
+
+        std::optional<std::decay_t<OBJECT>> ParseFile( const std::string& aPath )
+        {
+            const MappedFile lFile( aPath );
+
+            if ( !lFile.IsOpen() ) {
+                return std::nullopt;
+            }
+
+            return ( *this )( lFile.View() );
+        }
+
+        std::optional<std::decay_t<OBJECT>> operator ()( const std::string_view aJsonDocument,
+                                                         const StructuralIndex& aIndex )
         {
             if constexpr ( !IsObject<OBJECT>::value ) {
                 return std::nullopt;
             }
 
-            JsonParser  lParser;
-            JsonElement lResult;
+            JsonElement                         lResult;
+            MapParserNotifier                   lNotifier( lResult );
+            BasicJsonParser<MapParserNotifier>& lParser = BasicJsonParser<MapParserNotifier>::ForThread();
 
-            if ( !lParser.Parse( aJsonDocument, std::make_shared<jsbjson::MapParserNotifier>( lResult ) ) ) {
+            if ( !lParser.Parse( aJsonDocument, aIndex, lNotifier ) ) {
+                return std::nullopt;
+            }
+
+            return FromElement( lResult );
+        }
+
+        /*!
+         * Binds without building a JsonElement, keys the object does not declare
+         * are skipped. See OnDemandBinder.
+         */
+        std::optional<std::decay_t<OBJECT>> OnDemand( const std::string_view aJsonDocument )
+        {
+            return OnDemandBinder<OBJECT> {}( aJsonDocument );
+        }
+
+        /*!
+         * Binds from a tape document by the same rules as from a JsonElement.
+         */
+        std::optional<std::decay_t<OBJECT>> FromTape( const JsonTape& aTape )
+        {
+            if constexpr ( !IsObject<OBJECT>::value ) {
+                return std::nullopt;
+            }
+
+            const std::optional<TapeObject> lRoot = aTape.Root().GetValue<TapeObject>();
+
+            if ( !lRoot.has_value() ) {
+                return std::nullopt;
+            }
+
+            OBJECT lObject;
+            BindTape( lObject, lRoot.value() );
+            return lObject;
+        }
+
+        std::optional<std::decay_t<OBJECT>> FromElement( const JsonElement& aElement )
+        {
+            if constexpr ( !IsObject<OBJECT>::value ) {
                 return std::nullopt;
             }
 
@@ -149,7 +295,7 @@ namespace jsbjson
             auto lValuesAsTuple = lObject.ConvertRef();
             std::apply( [ & ] (auto&... aArgs)
                         {
-                            ( Process<decltype( aArgs )>( std::forward<decltype( aArgs )>( aArgs ), lResult ), ... );
+                            ( Process<decltype( aArgs )>( std::forward<decltype( aArgs )>( aArgs ), aElement ), ... );
                         }, lValuesAsTuple );
 
             return lObject;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include "jsonstring.h"
 
 namespace jsbjson
 {
@@ -110,7 +112,16 @@ namespace jsbjson
     {
         std::string operator ()( const std::string& aVal )
         {
-            return "\"" + aVal + "\"";
+            return text::Quote( aVal );
+        }
+    };
+
+    template<>
+    struct ToSimpleValue<std::string_view>
+    {
+        std::string operator ()( const std::string_view aVal )
+        {
+            return text::Quote( aVal );
         }
     };
 }
@@ -30,9 +30,21 @@ namespace jsbjson
     template<class T>
     struct IsObject<T, std::void_t<decltype( T::IsAJsonObject )>>: std::true_type {};
 
+    template<class T, class = void>
+    struct IsTransparent : std::false_type {};
+
+    template<class T>
+    struct IsTransparent<T, std::void_t<typename T::is_transparent>>: std::true_type {};
+
     template<class T, class = void>
     struct HasConvertRef : std::false_type {};
 
     template<class T>
     struct HasConvertRef<T, std::void_t<decltype( std::declval<T&>().ConvertRef() )>>: std::true_type {};
+
+    template<class T, class = void>
+    struct HasIsDone : std::false_type {};
+
+    template<class T>
+    struct HasIsDone<T, std::void_t<decltype( std::declval<const T&>().IsDone() )>>: std::true_type {};
 }
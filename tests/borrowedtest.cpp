@@ -0,0 +1,101 @@
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "jsonelementex.h"
+
+namespace
+{
+    using jsbjson::JsonVariant;
+
+    size_t gFailures = 0;
+
+    void Check( const bool  aCondition,
+                const char* aWhat )
+    {
+        if ( !aCondition ) {
+            std::printf( "failed: %s\n", aWhat );
+            ++gFailures;
+        }
+    }
+
+    /*!
+     * Whether aVariant holds aText as a view into aDocument.
+     */
+    bool PointsInto( const JsonVariant&     aVariant,
+                     const std::string&     aDocument,
+                     const std::string_view aText )
+    {
+        const std::optional<std::string_view> lView = aVariant.GetValue<std::string_view>();
+
+        return aVariant.IsBorrowed()
+               && lView
+               && ( *lView == aText )
+               && ( lView->data() >= aDocument.data() )
+               && ( lView->data() + lView->size() <= aDocument.data() + aDocument.size() );
+    }
+
+    /*!
+     * Whether aVariant holds a copy of aText.
+     */
+    bool Copied( const JsonVariant&     aVariant,
+                 const std::string&     aDocument,
+                 const std::string_view aText )
+    {
+        const std::optional<std::string_view> lView = aVariant.GetValue<std::string_view>();
+
+        return !aVariant.IsBorrowed()
+               && lView
+               && ( *lView == aText )
+               && ( ( lView->data() < aDocument.data() ) || ( lView->data() >= aDocument.data() + aDocument.size() ) );
+    }
+}
+
+int main()
+{
+    const std::string lLong     = "a plain string long enough to be borrowed";
+    const std::string lDocument = "{\"long\":\"" + lLong + "\","
+                                  "\"short\":\"tiny\","
+                                  "\"escaped\":\"an escaped \\\"string\\\" long enough\","
+                                  "\"unicode\":\"caf\\u00e9 with an escape, long enough\","
+                                  "\"number\":12,"
+                                  "\"items\":[\"" + lLong + "\",{\"inner\":\"" + lLong + "\"}]}";
+
+    jsbjson::JsonElementEx lBorrowed;
+    jsbjson::JsonElementEx lCopied;
+
+    Check( lBorrowed.FromJsonBorrowed( lDocument ), "borrowed parse" );
+    Check( lCopied.FromJson( lDocument ), "copying parse" );
+    Check( lBorrowed.ToJson() == lCopied.ToJson(), "both parses hold the same document" );
+
+    const jsbjson::JsonElement& lConst = lBorrowed;
+
+    Check( PointsInto( lConst.at( "long" ), lDocument, lLong ), "a plain string points into the input" );
+    Check( Copied( lConst.at( "short" ), lDocument, "tiny" ), "a short string is stored inline" );
+    Check( Copied( lConst.at( "escaped" ), lDocument, "an escaped \"string\" long enough" ), "an escaped string is copied" );
+    Check( Copied( lConst.at( "unicode" ), lDocument, "caf\xc3\xa9 with an escape, long enough" ), "a unicode escape is copied" );
+    Check( lConst.at( "number" ).GetValue<int64_t>() == 12, "numbers are unaffected" );
+
+    const std::vector<JsonVariant>& lItems = lConst.at( "items" ).GetValueRef<std::vector<JsonVariant>>();
+    Check( ( lItems.size() == 2 ) && PointsInto( lItems[ 0 ], lDocument, lLong ), "array items are borrowed" );
+    Check( PointsInto( lItems[ 1 ].GetValueRef<jsbjson::JsonElement>().at( "inner" ), lDocument, lLong ), "nested members are borrowed" );
+    Check( !lCopied.at( "long" ).IsBorrowed(), "FromJson copies every string" );
+
+    // copies keep pointing into the input, GetValue<std::string>() copies
+    const JsonVariant lCopy = lConst.at( "long" );
+    Check( PointsInto( lCopy, lDocument, lLong ), "a copy of a borrowed value is borrowed" );
+    Check( lCopy.GetValue<std::string>() == lLong, "GetValue<std::string>() reads a borrowed string" );
+
+    // GetValueRef<std::string>() takes the string out of the input
+    std::string& lOwned = lBorrowed[ "long" ].GetValueRef<std::string>();
+    lOwned += "!";
+    Check( Copied( lBorrowed[ "long" ], lDocument, lLong + "!" ), "GetValueRef<std::string>() owns the string" );
+    Check( PointsInto( lCopy, lDocument, lLong ), "other copies still borrow" );
+
+    std::printf( "%zu failures\n", gFailures );
+    return gFailures == 0
+           ? 0
+           : 1;
+}
@@ -0,0 +1,113 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "frommap.h"
+#include "jsonelementex.h"
+#include "mapparsernotifier.h"
+#include "parser.h"
+
+namespace
+{
+    size_t gFailures = 0;
+
+    void Check( const bool  aCondition,
+                const char* aWhat )
+    {
+        if ( !aCondition ) {
+            std::printf( "failed: %s\n", aWhat );
+            ++gFailures;
+        }
+    }
+
+    /*!
+     * Parses aJsonDocument pushed in chunks of aChunkSize bytes, the last
+     * chunk ends at aSplit first when it is set.
+     */
+    bool ParseChunked( const std::string_view aJsonDocument,
+                       const size_t           aSplit,
+                       const size_t           aChunkSize,
+                       jsbjson::JsonElement&  aResult )
+    {
+        jsbjson::JsonParser lParser;
+
+        if ( !lParser.Start( std::make_shared<jsbjson::MapParserNotifier>( aResult ) ) ) {
+            return false;
+        }
+
+        size_t lOffset = 0;
+
+        if ( aSplit > 0 ) {
+            if ( !lParser.Feed( aJsonDocument.substr( 0, aSplit ) ) ) {
+                return false;
+            }
+
+            lOffset = aSplit;
+        }
+
+        for ( ; lOffset < aJsonDocument.size(); lOffset += aChunkSize ) {
+            if ( !lParser.Feed( aJsonDocument.substr( lOffset, aChunkSize ) ) ) {
+                return false;
+            }
+        }
+
+        return lParser.Finish();
+    }
+}
+
+int main()
+{
+    const std::string lDocument = R"({ "name" : "caf\u00e9 \"au\" lait\n", "emoji":"\ud83d\ude00", "count":18446744073709551615,)"
+                                  R"( "low":-9223372036854775808, "ratio":-12.5e-3, "flag":true, "off":false,)"
+                                  R"( "list":[ 1, "two", [ 3.25 ], { "deep" : "value" } ], "empty":{} })";
+
+    jsbjson::JsonElementEx lWhole;
+    Check( lWhole.FromJson( lDocument ), "whole document parses" );
+
+    Check( lWhole[ "name" ].GetValue<std::string>() == std::string( "caf\xc3\xa9 \"au\" lait\n" ), "escapes in name" );
+    Check( lWhole[ "emoji" ].GetValue<std::string>() == std::string( "\xf0\x9f\x98\x80" ), "surrogate pair" );
+    Check( lWhole[ "count" ].GetValue<uint64_t>() == UINT64_MAX, "largest uint64" );
+    Check( lWhole[ "low" ].GetValue<int64_t>() == INT64_MIN, "smallest int64" );
+    Check( lWhole[ "ratio" ].GetValue<double>() == -12.5e-3, "double with exponent" );
+    Check( lWhole[ "flag" ].GetValue<bool>() == true, "true" );
+    Check( lWhole[ "off" ].GetValue<bool>() == false, "false" );
+
+    const std::optional<std::vector<jsbjson::JsonVariant>> lList = lWhole[ "list" ].GetValue<std::vector<jsbjson::JsonVariant>>();
+    Check( lList.has_value() && ( lList->size() == 4 ), "list size" );
+
+    if ( lList.has_value() && ( lList->size() == 4 ) ) {
+        Check( ( *lList )[ 0 ].GetValue<int64_t>() == 1, "list number" );
+        Check( ( *lList )[ 1 ].GetValue<std::string>() == std::string( "two" ), "list string" );
+        Check( ( *lList )[ 2 ].GetValue<std::vector<jsbjson::JsonVariant>>()->at( 0 ).GetValue<double>() == 3.25, "nested list" );
+        Check( ( *lList )[ 3 ].GetValue<jsbjson::JsonElement>()->at( "deep" ).GetValue<std::string>() == std::string( "value" ), "object in list" );
+    }
+
+    const std::string lExpected = jsbjson::FromMap {}( lWhole );
+
+    // every split point, so each token is cut at every byte once
+    for ( size_t lSplit = 1; lSplit < lDocument.size(); ++lSplit ) {
+        jsbjson::JsonElement lResult;
+
+        if ( !ParseChunked( lDocument, lSplit, lDocument.size(), lResult ) || ( jsbjson::FromMap {}( lResult ) != lExpected ) ) {
+            std::printf( "failed: split at %zu\n", lSplit );
+            ++gFailures;
+        }
+    }
+
+    for ( const size_t lChunkSize : { 1, 2, 3, 7 } ) {
+        jsbjson::JsonElement lResult;
+
+        if ( !ParseChunked( lDocument, 0, lChunkSize, lResult ) || ( jsbjson::FromMap {}( lResult ) != lExpected ) ) {
+            std::printf( "failed: chunks of %zu bytes\n", lChunkSize );
+            ++gFailures;
+        }
+    }
+
+    jsbjson::JsonElement lTruncated;
+    Check( !ParseChunked( lDocument.substr( 0, lDocument.size() - 1 ), 0, 5, lTruncated ), "truncated document fails" );
+
+    std::printf( "%zu failures\n", gFailures );
+    return gFailures == 0
+           ? 0
+           : 1;
+}
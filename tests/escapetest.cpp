@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "jsonelementex.h"
+#include "mapparsernotifier.h"
+#include "parser.h"
+
+namespace
+{
+    size_t gFailures = 0;
+
+    void Check( const bool  aCondition,
+                const char* aWhat )
+    {
+        if ( !aCondition ) {
+            std::printf( "failed: %s\n", aWhat );
+            ++gFailures;
+        }
+    }
+
+    /*!
+     * Parses {"<aKey>":"<aValue>"} with the indexed, the streaming and the
+     * borrowing parse, all have to agree.
+     */
+    bool Decode( const std::string_view aKey,
+                 const std::string_view aValue,
+                 std::string&           aDecodedKey,
+                 std::string&           aDecodedValue )
+    {
+        const std::string lDocument = "{\"" + std::string( aKey ) + "\":\"" + std::string( aValue ) + "\"}";
+
+        jsbjson::JsonElementEx lIndexed;
+        jsbjson::JsonElement   lStreamed;
+        jsbjson::JsonElementEx lBorrowed;
+        jsbjson::JsonParser    lParser;
+
+        const bool lIndexedOk  = lIndexed.FromJson( lDocument );
+        const bool lStreamedOk = lParser.Parse( lDocument, std::make_shared<jsbjson::MapParserNotifier>( lStreamed ) );
+        const bool lBorrowedOk = lBorrowed.FromJsonBorrowed( lDocument );
+
+        if ( ( lIndexedOk != lStreamedOk ) || ( lIndexedOk != lBorrowedOk ) ) {
+            std::printf( "parse modes disagree on %s\n", lDocument.c_str() );
+            ++gFailures;
+            return false;
+        }
+
+        if ( !lIndexedOk || ( lIndexed.size() != 1 ) || ( lStreamed.size() != 1 ) || ( lBorrowed.size() != 1 ) ) {
+            return false;
+        }
+
+        aDecodedKey   = lIndexed.begin()->first.Str();
+        aDecodedValue = lIndexed.begin()->second.GetValue<std::string>().value_or( "" );
+
+        if ( ( lStreamed.begin()->first.Str() != aDecodedKey )
+             || ( lBorrowed.begin()->first.Str() != aDecodedKey )
+             || ( lStreamed.begin()->second.GetValue<std::string>() != aDecodedValue )
+             || ( lBorrowed.begin()->second.GetValue<std::string>() != aDecodedValue ) )
+        {
+            std::printf( "parse modes decode differently: %s\n", lDocument.c_str() );
+            ++gFailures;
+        }
+
+        return true;
+    }
+
+    void Expect( const std::string_view aEscaped,
+                 const std::string_view aDecoded )
+    {
+        std::string lKey;
+        std::string lValue;
+
+        if ( !Decode( aEscaped, aEscaped, lKey, lValue ) || ( lKey != aDecoded ) || ( lValue != aDecoded ) ) {
+            std::printf( "failed: \"%.*s\" decodes to \"%s\"\n", static_cast<int>( aEscaped.size() ), aEscaped.data(), lValue.c_str() );
+            ++gFailures;
+        }
+    }
+
+    void ExpectInvalid( const std::string_view aEscaped )
+    {
+        std::string lKey;
+        std::string lValue;
+
+        if ( Decode( "k", aEscaped, lKey, lValue ) || Decode( aEscaped, "v", lKey, lValue ) ) {
+            std::printf( "failed: \"%.*s\" is accepted\n", static_cast<int>( aEscaped.size() ), aEscaped.data() );
+            ++gFailures;
+        }
+    }
+}
+
+int main()
+{
+    Expect( R"(plain)", "plain" );
+    Expect( R"(\"\\\/)", "\"\\/" );
+    Expect( R"(\b\f\n\r\t)", "\b\f\n\r\t" );
+    Expect( R"(\u0061A\u0062)", "aAb" );
+    Expect( R"(\u00e9\u00E9)", "\xc3\xa9\xc3\xa9" );
+    Expect( R"(\u20ac)", "\xe2\x82\xac" );
+    Expect( R"(\ud83d\ude00)", "\xf0\x9f\x98\x80" );
+    Expect( R"(\u0000)", std::string_view( "\0", 1 ) );
+    Expect( R"(a long value past the inline size \n with an escape)", "a long value past the inline size \n with an escape" );
+
+    ExpectInvalid( R"(\x)" );
+    ExpectInvalid( R"(\u12)" );
+    ExpectInvalid( R"(\u12g4)" );
+    ExpectInvalid( R"(\ud83d)" );
+    ExpectInvalid( R"(\ud83dx)" );
+    ExpectInvalid( R"(\ude00)" );
+
+    // escaped text survives a round trip through ToJson()
+    jsbjson::JsonElementEx lElement;
+    Check( lElement.FromJson( R"({"q\"k":"line\nbreak \u0001 \"quoted\" \\"})" ), "round trip source parses" );
+
+    jsbjson::JsonElementEx lCopy;
+    Check( lCopy.FromJson( lElement.ToJson() ), "round trip output parses" );
+    Check( lCopy[ "q\"k" ].GetValue<std::string>() == std::string( "line\nbreak \x01 \"quoted\" \\" ), "round trip value" );
+
+    std::printf( "%zu failures\n", gFailures );
+    return gFailures == 0
+           ? 0
+           : 1;
+}
@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "orderedmap.h"
+
+namespace
+{
+    /*!
+     * Hashes keys and text alike so the map can be searched by text.
+     */
+    struct TextHash
+    {
+        using is_transparent = void;
+
+        size_t operator()( const std::string_view aText ) const
+        {
+            return std::hash<std::string_view> {}( aText );
+        }
+    };
+
+    using Map = jsbjson::OrderedMap<std::string, int, TextHash>;
+
+    size_t gFailures = 0;
+
+    void Check( const bool  aCondition,
+                const char* aWhat )
+    {
+        if ( !aCondition ) {
+            std::printf( "failed: %s\n", aWhat );
+            ++gFailures;
+        }
+    }
+
+    std::string Key( const size_t aIndex )
+    {
+        return "k" + std::to_string( aIndex );
+    }
+
+    /*!
+     * Whether aMap holds exactly aKeys, in this order, and finds each of
+     * them by key and by text.
+     */
+    bool Holds( const Map&                      aMap,
+                const std::vector<std::string>& aKeys )
+    {
+        if ( aMap.size() != aKeys.size() ) {
+            return false;
+        }
+
+        size_t lPosition = 0;
+
+        for ( const auto& [lKey, lValue] : aMap ) {
+            if ( lKey != aKeys[ lPosition ] ) {
+                return false;
+            }
+
+            ++lPosition;
+        }
+
+        for ( const std::string& lKey : aKeys ) {
+            if ( ( aMap.find( lKey ) == aMap.end() )
+                 || ( aMap.find( std::string_view( lKey ) ) != aMap.find( lKey ) )
+                 || ( aMap.count( lKey.c_str() ) != 1 ) ) {
+                return false;
+            }
+        }
+
+        return ( aMap.find( std::string_view( "missing" ) ) == aMap.end() )
+               && ( aMap.count( "missing" ) == 0 );
+    }
+}
+
+int main()
+{
+    Map                      lMap;
+    std::vector<std::string> lKeys;
+
+    // lookups before, at and after the switch to the index
+    for ( size_t lIndex = 0; lIndex < 40; ++lIndex ) {
+        lMap[ Key( lIndex ) ] = static_cast<int>( lIndex );
+        lKeys.push_back( Key( lIndex ) );
+        Check( Holds( lMap, lKeys ), "insertion order and lookup while growing" );
+    }
+
+    lMap[ std::string_view( "k3" ) ] = 300;
+    Check( ( lMap.size() == 40 ) && ( lMap.at( "k3" ) == 300 ) && ( lMap.begin()[ 3 ].second == 300 ),
+           "assigning to an existing key keeps its position" );
+
+    // erase back below the threshold, every erase reindexes
+    while ( lKeys.size() > 10 ) {
+        const size_t lErased = lKeys.size() / 3;
+        Check( lMap.erase( lKeys[ lErased ] ) == 1, "erase an existing key" );
+        lKeys.erase( lKeys.begin() + lErased );
+        Check( Holds( lMap, lKeys ), "insertion order and lookup after erase" );
+    }
+
+    Check( lMap.erase( std::string( "missing" ) ) == 0, "erase a missing key" );
+
+    const auto lNext = lMap.erase( lMap.begin() );
+    lKeys.erase( lKeys.begin() );
+    Check( ( lNext == lMap.begin() ) && Holds( lMap, lKeys ), "erase by iterator returns the next entry" );
+
+    // text is only turned into a key when it is missing
+    Map lText;
+    lText[ "a" ] = 1;
+    lText[ std::string_view( "a" ) ] += 1;
+    Check( ( lText.size() == 1 ) && ( lText.at( std::string_view( "a" ) ) == 2 ), "operator[] with text" );
+
+    bool lThrown = false;
+
+    try {
+        lText.at( "b" );
+    }
+    catch ( const std::out_of_range& ) {
+        lThrown = true;
+    }
+
+    Check( lThrown, "at throws for a missing key" );
+
+    // references stay valid while entries are added
+    Map lStable;
+    lStable[ "b" ] = 7;
+    lStable[ "a" ] = lStable[ "b" ];
+    Check( ( lStable.at( "a" ) == 7 ) && ( lStable.begin()->first == "b" ), "e[\"a\"] = e[\"b\"]" );
+
+    for ( const size_t lSize : { 3, 4, 5, 11, 12, 15, 16 } ) {
+        Map lGrown;
+
+        for ( size_t lEntry = 0; lEntry < lSize; ++lEntry ) {
+            lGrown[ Key( lEntry ) ] = 5;
+        }
+
+        lGrown[ "new" ] = lGrown[ Key( 0 ) ];
+        Check( lGrown.at( "new" ) == 5, "assigning an entry to a new key when a chunk fills up" );
+    }
+
+    int&               lFirst = lStable.at( "b" );
+    const std::string* lKey   = &lStable.begin()->first;
+
+    for ( size_t lIndex = 0; lIndex < 1000; ++lIndex ) {
+        lStable.try_emplace( Key( lIndex ), static_cast<int>( lIndex ) );
+    }
+
+    lFirst = 8;
+    Check( ( lStable.at( "b" ) == 8 ) && ( *lKey == "b" ) && ( lStable.at( "k999" ) == 999 ),
+           "references held while 1000 entries are added" );
+
+    // copies and swaps keep order and index
+    Map lCopy = lStable;
+    lCopy.erase( std::string( "b" ) );
+    Check( ( lCopy.size() == 1001 ) && ( lStable.size() == 1002 ) && ( lCopy.begin()->first == "a" ),
+           "a copy is independent" );
+
+    lCopy.swap( lMap );
+    Check( Holds( lCopy, lKeys ) && ( lMap.size() == 1001 ) && ( lMap.at( "k500" ) == 500 ), "swap" );
+
+    lCopy = std::move( lStable );
+    Check( ( lCopy.size() == 1002 ) && ( lCopy.at( "k10" ) == 10 ), "move assignment" );
+
+    lCopy.clear();
+    Check( lCopy.empty() && ( lCopy.find( "a" ) == lCopy.end() ), "clear" );
+
+    std::printf( "%zu failures\n", gFailures );
+    return gFailures == 0
+           ? 0
+           : 1;
+}
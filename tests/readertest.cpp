@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <string>
+#include "jsonreader.h"
+#include "parser.h"
+
+namespace
+{
+    size_t gFailures = 0;
+
+    void Check( const bool  aCondition,
+                const char* aWhat )
+    {
+        if ( !aCondition ) {
+            std::printf( "failed: %s\n", aWhat );
+            ++gFailures;
+        }
+    }
+
+    /*!
+     * {"a":[[...[1]...]]} with aDepth containers open around the 1.
+     */
+    std::string Nested( const size_t aDepth )
+    {
+        return "{\"a\":" + std::string( aDepth - 1, '[' ) + "1" + std::string( aDepth - 1, ']' ) + "}";
+    }
+
+    /*!
+     * Reads every event, returns the deepest depth seen or 0 on an error.
+     */
+    size_t ReadAll( const std::string& aJsonDocument )
+    {
+        jsbjson::JsonReader lReader;
+        size_t              lDeepest = 0;
+
+        if ( !lReader.Start( aJsonDocument ) ) {
+            return 0;
+        }
+
+        while ( true ) {
+            const jsbjson::JsonReader::eEvent lEvent = lReader.Next();
+
+            if ( lEvent == jsbjson::JsonReader::eEvent::Error ) {
+                return 0;
+            }
+
+            if ( lEvent == jsbjson::JsonReader::eEvent::End ) {
+                return lDeepest;
+            }
+
+            lDeepest = std::max( lDeepest, lReader.Depth() );
+        }
+    }
+
+    /*!
+     * Skips the value of "a", returns whether the document reads to its end.
+     */
+    bool SkipAll( const std::string& aJsonDocument )
+    {
+        jsbjson::JsonReader lReader;
+
+        if ( !lReader.Start( aJsonDocument )
+             || ( lReader.Next() != jsbjson::JsonReader::eEvent::StartObject )
+             || ( lReader.Next() != jsbjson::JsonReader::eEvent::Key )
+             || !lReader.Skip() )
+        {
+            return false;
+        }
+
+        return ( lReader.Next() == jsbjson::JsonReader::eEvent::EndObject )
+               && ( lReader.Next() == jsbjson::JsonReader::eEvent::End );
+    }
+}
+
+int main()
+{
+    constexpr size_t kMaxDepth = jsbjson::JsonReader::kDefaultMaxDepth;
+
+    Check( kMaxDepth == jsbjson::BasicJsonParser<jsbjson::IParserNotifier>::kDefaultMaxDepth, "same limit as the parser" );
+    Check( ReadAll( Nested( kMaxDepth ) ) == kMaxDepth, "deepest allowed nesting reads" );
+    Check( ReadAll( Nested( kMaxDepth + 1 ) ) == 0, "nesting past the limit is an error" );
+    Check( ReadAll( Nested( 100000 ) ) == 0, "very deep nesting is an error" );
+    Check( SkipAll( Nested( kMaxDepth ) ), "deepest allowed nesting skips" );
+    Check( !SkipAll( Nested( kMaxDepth + 1 ) ), "skipping nesting past the limit is an error" );
+
+    jsbjson::JsonReader lShallow( 2 );
+    Check( lShallow.Start( "{\"a\":[1],\"b\":[[2]]}" ), "shallow reader starts" );
+
+    size_t lEvents = 0;
+
+    while ( lShallow.Next() != jsbjson::JsonReader::eEvent::Error ) {
+        Check( ++lEvents < 10, "shallow reader stops at the third level" );
+
+        if ( lEvents >= 10 ) {
+            break;
+        }
+    }
+
+    Check( lEvents == 7, "events before the third level" );
+
+    std::printf( "%zu failures\n", gFailures );
+    return gFailures == 0
+           ? 0
+           : 1;
+}
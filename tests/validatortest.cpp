@@ -0,0 +1,144 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "jsonvalidator.h"
+#include "parser.h"
+
+namespace
+{
+    /*!
+     * Handler that only tells whether a document parses.
+     */
+    class NullNotifier final : public jsbjson::IParserViewNotifier
+    {
+    public:
+        void OnParsingStarted() override {}
+        void OnObjectBegin( const size_t, const size_t, const std::string_view ) override {}
+        void OnObjectFinished( const size_t ) override {}
+        void OnItemBegin( const size_t ) override {}
+        void OnItemName( const std::string_view, const size_t ) override {}
+        void OnItemValueBegin( const eValueType ) override {}
+        void OnItemValue( const Value&, const size_t, const std::string_view ) override {}
+        void OnArrayBegin( const size_t, const size_t, const std::string_view ) override {}
+        void OnNextItem() override {}
+        void OnArrayFinished( const size_t ) override {}
+        void OnParsingFinished() override {}
+        void OnError( const std::string& ) override {}
+    };
+
+    bool Parses( const std::string_view aJsonDocument )
+    {
+        NullNotifier                          lNotifier;
+        jsbjson::BasicJsonParser<NullNotifier> lParser;
+        return lParser.ParseIndexed( aJsonDocument, lNotifier );
+    }
+
+    std::string Nested( const size_t aDepth )
+    {
+        std::string lResult = "{\"a\":";
+
+        for ( size_t lIndex = 1; lIndex < aDepth; ++lIndex ) {
+            lResult += "[";
+        }
+
+        lResult += "1";
+
+        for ( size_t lIndex = 1; lIndex < aDepth; ++lIndex ) {
+            lResult += "]";
+        }
+
+        return lResult + "}";
+    }
+}
+
+int main()
+{
+    const std::vector<std::string> lValid = {
+        "{}",
+        " { \"a\" : [ 1, -2.5e3, true, false, \"x\\n\\u00e9\" ], \"b\" : { \"c\" : {} } } ",
+        "{\"a\":\"\xc3\xa9\",\"b\":[[],[{}]]}",
+        Nested( jsbjson::JsonValidator::kDefaultMaxDepth )
+    };
+
+    const std::vector<std::string> lSeeds = {
+        "[1,2]",
+        "5",
+        "\"x\"",
+        "true",
+        "",
+        "{\"a\":1,}",
+        "{\"a\" 1}",
+        "{\"a\":01}",
+        "{\"a\":\"\\q\"}",
+        "{\"a\":\"unterminated}",
+        "{\"a\":1}}",
+        "{\"a\":[1,2}",
+        Nested( jsbjson::JsonValidator::kDefaultMaxDepth + 1 ),
+        Nested( 2000 )
+    };
+
+    size_t lFailures = 0;
+
+    for ( const std::string& lDocument : lValid ) {
+        if ( !jsbjson::JsonValidator {}.Validate( lDocument ) || !Parses( lDocument ) ) {
+            std::printf( "valid document rejected: %.60s\n", lDocument.c_str() );
+            ++lFailures;
+        }
+    }
+
+    std::vector<std::string> lInputs = lSeeds;
+
+    // every truncation and a spread of single byte changes of the valid documents
+    uint32_t lRandom = 12345;
+
+    for ( const std::string& lDocument : lValid ) {
+        for ( size_t lSize = 0; lSize < std::min<size_t>( lDocument.size(), 200 ); ++lSize ) {
+            lInputs.push_back( lDocument.substr( 0, lSize ) );
+        }
+
+        for ( size_t lRound = 0; lRound < 500; ++lRound ) {
+            static const char kBytes[] = "{}[],:\"\\ 0-.eE1tfx\x01\xc3";
+
+            lRandom = lRandom * 1103515245 + 12345;
+            std::string lChanged = lDocument;
+            lChanged[ ( lRandom >> 8 ) % lChanged.size() ] = kBytes[ ( lRandom >> 20 ) % ( sizeof( kBytes ) - 1 ) ];
+            lInputs.push_back( lChanged );
+        }
+    }
+
+    for ( const std::string& lDocument : lInputs ) {
+        size_t     lErrorOffset = 0;
+        const bool lValidates   = jsbjson::JsonValidator {}.Validate( lDocument, lErrorOffset );
+
+        if ( lValidates && !Parses( lDocument ) ) {
+            std::printf( "validates but does not parse: %.60s\n", lDocument.c_str() );
+            ++lFailures;
+        }
+
+        if ( !lValidates && ( lErrorOffset > lDocument.size() ) ) {
+            std::printf( "error offset %zu outside the document: %.60s\n", lErrorOffset, lDocument.c_str() );
+            ++lFailures;
+        }
+    }
+
+    for ( size_t lIndex = 0; lIndex < 6; ++lIndex ) {
+        if ( jsbjson::JsonValidator {}.Validate( lSeeds[ lIndex ] ) ) {
+            std::printf( "non-object root accepted: %s\n", lSeeds[ lIndex ].c_str() );
+            ++lFailures;
+        }
+    }
+
+    size_t lErrorOffset = 0;
+
+    if ( jsbjson::JsonValidator {}.Validate( "{\"a\":\"open}", lErrorOffset ) || ( lErrorOffset != 5 ) ) {
+        std::printf( "unterminated string reported at %zu instead of 5\n", lErrorOffset );
+        ++lFailures;
+    }
+
+    std::printf( "%zu inputs, %zu failures\n", lInputs.size(), lFailures );
+    return lFailures == 0
+           ? 0
+           : 1;
+}
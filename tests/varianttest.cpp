@@ -0,0 +1,172 @@
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "jsonelementex.h"
+
+namespace
+{
+    using jsbjson::JsonVariant;
+    using eType = JsonVariant::eType;
+
+    size_t gFailures = 0;
+
+    void Check( const bool  aCondition,
+                const char* aWhat )
+    {
+        if ( !aCondition ) {
+            std::printf( "failed: %s\n", aWhat );
+            ++gFailures;
+        }
+    }
+
+    /*!
+     * Whether every way of reading a string from a const value finds aText.
+     */
+    bool Reads( const JsonVariant&     aVariant,
+                const std::string_view aText )
+    {
+        std::string_view lVisited;
+        bool             lString = false;
+
+        aVariant.Visit( [&]( const auto& aValue ) {
+            if constexpr ( std::is_same_v<std::decay_t<decltype( aValue )>, std::string_view> ) {
+                lVisited = aValue;
+                lString  = true;
+            }
+        } );
+
+        return aVariant.IsA<std::string>()
+               && aVariant.IsA<std::string_view>()
+               && ( aVariant.GetValue<std::string_view>() == aText )
+               && ( aVariant.GetValue<std::string>() == std::string( aText ) )
+               && lString
+               && ( lVisited == aText )
+               && !aVariant.GetValue<int32_t>();
+    }
+}
+
+int main()
+{
+    Check( sizeof( JsonVariant ) == 16, "a variant takes 16 bytes" );
+
+    // numbers and bools are stored inline and read back as they were
+    const JsonVariant lInt32( int32_t( -7 ) );
+    const JsonVariant lUInt32( uint32_t( 7 ) );
+    const JsonVariant lInt64( std::numeric_limits<int64_t>::min() );
+    const JsonVariant lUInt64( std::numeric_limits<uint64_t>::max() );
+    const JsonVariant lSmall( uint64_t( 42 ) );
+    const JsonVariant lBool( true );
+    const JsonVariant lDouble( -12.5e-3 );
+    const JsonVariant lEmpty;
+
+    Check( ( lInt32.Type() == eType::Int32 ) && ( lInt32.GetValueRef<int32_t>() == -7 ), "int32" );
+    Check( ( lUInt32.Type() == eType::UInt32 ) && ( lUInt32.GetValue<uint32_t>() == 7u ), "uint32" );
+    Check( lInt64.GetValue<int64_t>() == std::numeric_limits<int64_t>::min(), "int64" );
+    Check( !lInt64.GetValue<uint64_t>(), "a negative int64 does not read as uint64" );
+    Check( lUInt64.GetValueRef<uint64_t>() == std::numeric_limits<uint64_t>::max(), "uint64" );
+    Check( !lUInt64.GetValue<int64_t>(), "a uint64 past INT64_MAX does not read as int64" );
+    Check( lSmall.GetValue<int64_t>() == 42, "a small uint64 reads as int64" );
+    Check( ( lBool.Type() == eType::Bool ) && lBool.GetValueRef<bool>(), "bool" );
+    Check( lDouble.GetValue<double>() == -12.5e-3, "double" );
+    Check( ( lEmpty.Type() == eType::Empty ) && lEmpty.IsA<jsbjson::sEmptyValue>() && !lEmpty.GetValue<std::string_view>(), "empty" );
+    Check( !lDouble.GetValue<bool>() && ( lDouble.GetValueRef<int32_t>() == 0 ), "reading another type" );
+
+    // short, long, owned and borrowed strings read the same through a const reference
+    const std::string lLongText( 100, 'l' );
+    const std::string lBorrowedText = "a borrowed string long enough to live outside";
+
+    const JsonVariant lShort( std::string( "fourteen bytes" ) );
+    const JsonVariant lLong( lLongText );
+    const JsonVariant lOwned { std::string( lLongText ) };
+    const JsonVariant lBorrowed    = JsonVariant::Borrowed( lBorrowedText );
+    const JsonVariant lNotBorrowed = JsonVariant::Borrowed( "short" );
+
+    Check( ( lShort.Type() == eType::ShortString ) && Reads( lShort, "fourteen bytes" ), "short string" );
+    Check( ( lLong.Type() == eType::Text ) && Reads( lLong, lLongText ), "long string" );
+    Check( ( lOwned.Type() == eType::String ) && Reads( lOwned, lLongText ), "owned string" );
+    Check( lBorrowed.IsBorrowed() && Reads( lBorrowed, lBorrowedText ), "borrowed string" );
+    Check( ( lBorrowed.GetValue<std::string_view>()->data() == lBorrowedText.data() ), "a borrowed string is not copied" );
+    Check( !lNotBorrowed.IsBorrowed() && Reads( lNotBorrowed, "short" ), "a short borrowed string is stored inline" );
+
+    // the non const GetValueRef<std::string>() turns any string into an owned one
+    for ( const JsonVariant& lSource : { lShort, lLong, lBorrowed } ) {
+        JsonVariant       lChanged = lSource;
+        const std::string lText    = *lSource.GetValue<std::string>();
+        std::string&      lString  = lChanged.GetValueRef<std::string>();
+
+        lString += "!";
+        Check( ( lChanged.Type() == eType::String ) && Reads( lChanged, lText + "!" ) && Reads( lSource, lText ),
+               "GetValueRef<std::string>() owns and changes a copy only" );
+    }
+
+    // objects and arrays, copies and moves
+    JsonVariant lObject;
+    lObject[ "name" ]  = std::string( lLongText );
+    lObject[ "items" ] = std::vector<JsonVariant> { 1, std::string( "two" ), true };
+
+    const JsonVariant& lConstObject = lObject;
+    const auto&        lMembers     = lConstObject.GetValueRef<jsbjson::JsonElement>();
+    Check( ( lConstObject.Type() == eType::Object ) && ( lMembers.size() == 2 ), "object" );
+    Check( Reads( lMembers.at( "name" ), lLongText ), "string member" );
+    Check( lMembers.at( "items" ).GetValueRef<std::vector<JsonVariant>>().size() == 3, "array member" );
+    Check( Reads( lMembers.at( "items" ).GetValueRef<std::vector<JsonVariant>>()[ 1 ], "two" ), "string item" );
+
+    JsonVariant lCopy = lObject;
+    lCopy[ "name" ]   = std::string( "changed" );
+    Check( Reads( lObject[ "name" ], lLongText ) && Reads( lCopy[ "name" ], "changed" ), "a copy is independent" );
+
+    JsonVariant lMoved = std::move( lCopy );
+    Check( ( lCopy.Type() == eType::Empty ) && Reads( lMoved[ "name" ], "changed" ), "move construction" );
+
+    lMoved = std::move( lMoved[ "items" ] );
+    Check( lMoved.IsArray() && ( lMoved.GetValueRef<std::vector<JsonVariant>>().size() == 3 ), "moving a part over its whole" );
+
+    lMoved = lObject;
+    lMoved = std::move( lMoved );
+    Check( ( lMoved.Type() == eType::Object ) && Reads( lMoved[ "name" ], lLongText ), "self move assignment" );
+
+    // moves take arena memory over, CopyTo() takes a value out of the arena
+    JsonVariant lKept;
+    JsonVariant lCopied;
+
+    {
+        jsbjson::JsonArena     lArena;
+        jsbjson::JsonElementEx lDocument;
+        Check( lDocument.FromJson( "{\"s\":\"" + lLongText + "\",\"o\":{\"a\":[\"" + lLongText + "\"]}}", lArena ), "parse in an arena" );
+
+        const char* lText = lDocument[ "s" ].GetValue<std::string_view>()->data();
+        lKept             = std::move( lDocument[ "s" ] );
+        Check( ( lKept.GetValue<std::string_view>()->data() == lText ) && ( lDocument[ "s" ].Type() == eType::Empty ),
+               "a move takes the block over" );
+
+        lKept   = lKept.CopyTo( std::pmr::new_delete_resource() );
+        lCopied = lDocument[ "o" ].CopyTo( std::pmr::new_delete_resource() );
+        Check( lKept.GetValue<std::string_view>()->data() != lText, "CopyTo() copies the block" );
+
+        lDocument.clear();
+        lArena.Release();
+    }
+
+    Check( Reads( lKept, lLongText ), "a copied string outlives the arena" );
+    Check( Reads( lCopied[ "a" ].GetValueRef<std::vector<JsonVariant>>()[ 0 ], lLongText ), "a copied object outlives the arena" );
+
+    // parsed documents
+    jsbjson::JsonElementEx lParsed;
+    Check( lParsed.FromJson( "{\"s\":\"short\",\"l\":\"" + lLongText + "\",\"e\":\"caf\\u00e9\",\"n\":-3}" ), "parse" );
+
+    const jsbjson::JsonElement& lConstParsed = lParsed;
+    Check( Reads( lConstParsed.at( "s" ), "short" ), "parsed short string" );
+    Check( Reads( lConstParsed.at( "l" ), lLongText ), "parsed long string" );
+    Check( Reads( lConstParsed.at( "e" ), "caf\xc3\xa9" ), "parsed escaped string" );
+    Check( lConstParsed.at( "n" ).GetValue<int64_t>() == -3, "parsed number" );
+
+    std::printf( "%zu failures\n", gFailures );
+    return gFailures == 0
+           ? 0
+           : 1;
+}